@@ -0,0 +1,123 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Timing of the fixed-size kernels
+//   `make bench` builds this twice, once normally and once with
+//   EUCLIB_NO_SIMD, and runs both so the results can be compared.
+//   `make bench_base BASE=<dir>` builds it against the headers of
+//   another checkout, e.g. one from git archive of an older commit.
+//   Each figure is the best of several runs.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <string>
+
+#include "point.hpp"
+#include "vector.hpp"
+
+using namespace euclib;
+using namespace std;
+
+
+template<typename F>
+void time_it( const string& name, std::size_t count, F func ) {
+	double ns = 0;
+	for( int run = 0; run < 7; ++run ) {
+		auto start = chrono::steady_clock::now( );
+		func( );
+		auto stop = chrono::steady_clock::now( );
+		double elapsed = chrono::duration<double,nano>( stop - start ).count( );
+		if( run == 0 || elapsed < ns ) { ns = elapsed; }
+	}
+	cout << "  " << left << setw(28) << name
+	     << right << setw(8) << fixed << setprecision(3) << ns / count << " ns/op\n";
+}
+
+template<typename V>
+void run( const string& type, std::size_t size, std::size_t repeat, mt19937& engine ) {
+	typedef typename V::value_t T;
+	uniform_real_distribution<T> unif( T(-1), T(1) );
+
+	std::vector<V> a( size ), b( size ), c( size );
+	for( std::size_t i = 0; i < size; ++i ) {
+		for( std::size_t d = 0; d < a[i].dimension( ); ++d ) {
+			a[i][d] = unif( engine );
+			b[i][d] = unif( engine );
+		}
+	}
+
+	const std::size_t count = size * repeat;
+	volatile T sink = 0;
+
+	cout << type << "\n";
+	time_it( "operator +=", count, [&]( ) {
+		for( std::size_t r = 0; r < repeat; ++r ) {
+			for( std::size_t i = 0; i < size; ++i ) { c[i] += a[i]; }
+		}
+	} );
+	time_it( "operator *=", count, [&]( ) {
+		for( std::size_t r = 0; r < repeat; ++r ) {
+			for( std::size_t i = 0; i < size; ++i ) { c[i] *= T(1.0001); }
+		}
+	} );
+	time_it( "dot( )", count, [&]( ) {
+		T sum = 0;
+		for( std::size_t r = 0; r < repeat; ++r ) {
+			for( std::size_t i = 0; i < size; ++i ) { sum += a[i].dot( b[i] ); }
+		}
+		sink = sum;
+	} );
+	time_it( "length_sq( )", count, [&]( ) {
+		T sum = 0;
+		for( std::size_t r = 0; r < repeat; ++r ) {
+			for( std::size_t i = 0; i < size; ++i ) { sum += a[i].length_sq( ); }
+		}
+		sink = sum;
+	} );
+	time_it( "c = 2 * ( a + b ) - a", count, [&]( ) {
+		for( std::size_t r = 0; r < repeat; ++r ) {
+			for( std::size_t i = 0; i < size; ++i ) { c[i] = T(2) * ( a[i] + b[i] ) - a[i]; }
+		}
+	} );
+#ifdef EUBLIB_SIMD_HPP	// trees from before simd.hpp have no batch kernels
+	time_it( "normalize( batch )", count, [&]( ) {
+		for( std::size_t r = 0; r < repeat; ++r ) { c = a; normalize( c ); }
+	} );
+#endif
+	(void)sink;
+}
+
+
+int main( ) {
+	mt19937 engine( 5489u );
+
+#ifdef EUCLIB_SIMD_SSE2
+	cout << "=== simd kernels ===\n";
+#else
+	cout << "=== scalar kernels ===\n";
+#endif
+
+	run<vector4f>( "vector4f", 1 << 12, 2000, engine );
+	run<vector2d>( "vector2d", 1 << 12, 2000, engine );
+	run<vector3f>( "vector3f", 1 << 12, 2000, engine );
+
+	return 0;
+}
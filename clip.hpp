@@ -0,0 +1,475 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_CLIP_HPP
+#define EUBLIB_CLIP_HPP
+
+#include <cstddef>	// for std::size_t
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cassert>
+
+#include "point.hpp"
+#include "vector.hpp"
+#include "line.hpp"
+#include "segment.hpp"
+#include "rect.hpp"
+
+/*
+ * Clipping against axis aligned rectangles
+ *
+ *   clip_polygon( ) is Sutherland-Hodgman with the four sides chained: each
+ *   vertex is pushed through all four half-planes as it is read, so there
+ *   is one pass over the input and nothing in between the stages.  The
+ *   polygon may be concave, in which case a piece that leaves the rect and
+ *   comes back is joined along the rect's side by a zero width bridge.
+ *
+ *   tile_polygon( ) cuts one polygon into the cells of a grid.  It slices off
+ *   a column at a time, and each column a row at a time, so every vertex is
+ *   copied about once per cut that reaches it rather than once per tile.
+ *
+ *   clip_segment( ) and clip_line( ) are Liang-Barsky: the part inside is
+ *   the range of the parameter along the segment that is inside both the
+ *   x and the y slab of the rect, found without computing a single point
+ *   on the rect's sides.  clip_segments( ) does the same for columns of
+ *   segments, in one pass and without branches.
+ *
+ *   Output goes to a clip_buffer, which keeps every piece in one flat array
+ *   and holds on to its memory across clear( ), so a buffer reused for a
+ *   stream of polygons stops allocating once it has seen the largest.
+ */
+
+namespace euclib {
+
+template<typename T>
+class clip_buffer {
+// Variables
+private:
+
+	std::vector<point2<T>>   m_points;
+	std::vector<std::size_t> m_offsets;    // piece i is [ m_offsets[i], m_offsets[i+1] )
+	std::vector<std::size_t> m_tiles;      // the tile each piece is in
+
+	// working space for tile_polygon( )
+	std::vector<point2<T>>   m_scratch[4];
+
+	template<typename ForwardIt, typename U>
+	friend std::size_t tile_polygon( ForwardIt, ForwardIt, const rect2<U>&,
+	                                 std::size_t, std::size_t, clip_buffer<U>& );
+
+
+// Constructors
+public:
+
+	clip_buffer( ) : m_offsets( 1, 0 ) { }
+
+
+// Methods
+public:
+
+	// drops the pieces but keeps the memory
+	void clear( ) {
+		m_points.clear( );
+		m_offsets.resize( 1 );
+		m_tiles.clear( );
+	}
+
+	void reserve( std::size_t points, std::size_t pieces ) {
+		m_points.reserve( points );
+		m_offsets.reserve( pieces + 1 );
+		m_tiles.reserve( pieces );
+	}
+
+	std::size_t size( ) const { return m_tiles.size( ); }
+	bool empty( ) const { return m_tiles.empty( ); }
+
+	// the vertices of piece i
+	const point2<T>* begin( std::size_t i ) const { return m_points.data( ) + m_offsets[i]; }
+	const point2<T>* end( std::size_t i ) const   { return m_points.data( ) + m_offsets[i+1]; }
+	std::size_t piece_size( std::size_t i ) const { return m_offsets[i+1] - m_offsets[i]; }
+	std::size_t tile( std::size_t i ) const       { return m_tiles[i]; }
+
+	// every piece back to back
+	const std::vector<point2<T>>& points( ) const { return m_points; }
+
+	// Building a piece by hand, push_back( ) its vertices then close_piece( )
+	//   anything under three vertices is dropped, returns whether it was kept
+	void push_back( const point2<T>& pt ) { m_points.push_back( pt ); }
+	bool close_piece( std::size_t tile = 0 ) {
+		if( m_points.size( ) - m_offsets.back( ) < 3 ) {
+			m_points.resize( m_offsets.back( ) );
+			return false;
+		}
+		m_offsets.push_back( m_points.size( ) );
+		m_tiles.push_back( tile );
+		return true;
+	}
+
+}; // End class clip_buffer<T>
+
+
+namespace detail { namespace clip {
+
+	// Where a->b crosses the line p[axis] == c, a and b on either side
+	//   worked out from the same end whichever way the edge runs, so the
+	//   pieces either side of a cut share the point exactly
+	template<typename T>
+	inline point2<T> crossing( point2<T> a, point2<T> b, std::size_t axis, T c ) {
+		const std::size_t other = 1 - axis;
+		if( b[axis] < a[axis] ) { std::swap( a, b ); }
+		point2<T> result;
+		result[axis]  = c;
+		result[other] = a[other] + ( b[other] - a[other] ) * ( ( c - a[axis] ) / ( b[axis] - a[axis] ) );
+		return result;
+	}
+
+	template<typename ForwardIt, typename T>
+	inline rect2<T> bounds( ForwardIt first, ForwardIt last ) {
+		T l = first->x( ), r = l, t = first->y( ), b = t;
+		for( ++first; first != last; ++first ) {
+			l = std::min( l, first->x( ) );
+			r = std::max( r, first->x( ) );
+			t = std::min( t, first->y( ) );
+			b = std::max( b, first->y( ) );
+		}
+		return rect2<T>( l, r, t, b );
+	}
+
+	// The four Sutherland-Hodgman stages as one state machine
+	//   stage k keeps x >= l, x <= r, y >= t, y <= b in turn and feeds k + 1,
+	//   the last feeds out
+	template<typename T, typename Out>
+	class pipeline {
+		T         m_bound[4];
+		point2<T> m_first[4];
+		point2<T> m_prev[4];
+		bool      m_started[4];
+		Out&      m_out;
+
+		bool inside( std::size_t k, const point2<T>& pt ) const {
+			return ( k & 1 ) ? pt[k >> 1] <= m_bound[k] : pt[k >> 1] >= m_bound[k];
+		}
+
+		void edge( std::size_t k, const point2<T>& a, const point2<T>& b ) {
+			const bool in_a = inside( k, a );
+			const bool in_b = inside( k, b );
+			if( in_a != in_b ) { push( k + 1, crossing( a, b, k >> 1, m_bound[k] ) ); }
+			if( in_b ) { push( k + 1, b ); }
+		}
+
+	public:
+
+		pipeline( const rect2<T>& rect, Out& out ) :
+			m_bound{ rect.l, rect.r, rect.t, rect.b },
+			m_started{ false, false, false, false },
+			m_out( out ) {
+		}
+
+		void push( std::size_t k, const point2<T>& pt ) {
+			if( k == 4 ) {
+				m_out.push_back( pt );
+				return;
+			}
+			if( m_started[k] ) { edge( k, m_prev[k], pt ); }
+			else {
+				m_started[k] = true;
+				m_first[k] = pt;
+			}
+			m_prev[k] = pt;
+		}
+
+		// the closing edges, in stage order since each feeds the next
+		void finish( ) {
+			for( std::size_t k = 0; k < 4; ++k ) {
+				if( m_started[k] ) { edge( k, m_prev[k], m_first[k] ); }
+			}
+		}
+	};
+
+	// Cuts src along p[axis] == c into the part below and the part above
+	template<typename T>
+	void split( const std::vector<point2<T>>& src, std::size_t axis, T c,
+	            std::vector<point2<T>>& below, std::vector<point2<T>>& above ) {
+		below.clear( );
+		above.clear( );
+		const point2<T>* a = &src.back( );
+		for( const point2<T>& b : src ) {
+			const T ca = (*a)[axis], cb = b[axis];
+			if( ( ca <= c ) != ( cb <= c ) ) { below.push_back( crossing( *a, b, axis, c ) ); }
+			if( cb <= c ) { below.push_back( b ); }
+			if( ( ca >= c ) != ( cb >= c ) ) { above.push_back( crossing( *a, b, axis, c ) ); }
+			if( cb >= c ) { above.push_back( b ); }
+			a = &b;
+		}
+	}
+
+	// The cells [ first, last ] of count cells of size step from origin
+	//   that the span [ lo, hi ] reaches into, false if none
+	template<typename T>
+	bool cells( T lo, T hi, T origin, T step, std::size_t count,
+	            std::size_t& first, std::size_t& last ) {
+		using std::floor;
+		using std::ceil;
+		const T f = floor( ( lo - origin ) / step );
+		const T l = ceil( ( hi - origin ) / step ) - T(1);
+		if( l < T(0) || f > T(count - 1) || l < f ) { return false; }
+		first = f < T(0) ? 0 : static_cast<std::size_t>( f );
+		last  = l > T(count - 1) ? count - 1 : static_cast<std::size_t>( l );
+		return first <= last;
+	}
+
+	template<typename T>
+	inline T line( T origin, T end, T step, std::size_t i, std::size_t count ) {
+		return ( i == count ) ? end : origin + step * T(i);
+	}
+
+	// Narrows [ enter, exit ] to where p + t v is in [ lo, hi ]
+	//   a zero v gives infinite ratios, which keep or empty the range
+	//   whole; one starting exactly on lo or hi gives a NaN, which the
+	//   comparisons pass over, as running along a side is inside
+	template<typename T>
+	inline void slab( T p, T v, T lo, T hi, T& enter, T& exit ) {
+		const T inv = T(1) / v;
+		const T a = ( lo - p ) * inv;
+		const T b = ( hi - p ) * inv;
+		const bool back = inv < T(0);
+		const T in  = back ? b : a;
+		const T out = back ? a : b;
+		enter = in > enter ? in : enter;
+		exit  = out < exit ? out : exit;
+	}
+
+	template<typename T>
+	inline bool liang_barsky( T px, T py, T vx, T vy, const rect2<T>& rect, T& t0, T& t1 ) {
+		slab( px, vx, rect.l, rect.r, t0, t1 );
+		slab( py, vy, rect.t, rect.b, t0, t1 );
+		return t0 <= t1;
+	}
+
+} } // End namespace detail::clip
+
+
+////////////////////////////////////////
+// Clip a polygon to a rect
+//   appends the part inside rect to out as one piece, tagged with tile,
+//   returns false if nothing was left of it
+
+template<typename ForwardIt, typename T>
+bool clip_polygon( ForwardIt first, ForwardIt last, const rect2<T>& rect,
+                   clip_buffer<T>& out, std::size_t tile = 0 ) {
+	if( std::distance( first, last ) < 3 ) { return false; }
+
+	// most polygons in a tiling are wholly in or wholly out
+	const rect2<T> box = detail::clip::bounds<ForwardIt,T>( first, last );
+	if( box.r < rect.l || box.l > rect.r || box.b < rect.t || box.t > rect.b ) {
+		return false;
+	}
+	if( box.l >= rect.l && box.r <= rect.r && box.t >= rect.t && box.b <= rect.b ) {
+		for( ; first != last; ++first ) { out.push_back( *first ); }
+		return out.close_piece( tile );
+	}
+
+	detail::clip::pipeline<T,clip_buffer<T>> stages( rect, out );
+	for( ; first != last; ++first ) { stages.push( 0, *first ); }
+	stages.finish( );
+	return out.close_piece( tile );
+}
+
+template<typename T>
+bool clip_polygon( const std::vector<point2<T>>& polygon, const rect2<T>& rect,
+                   clip_buffer<T>& out, std::size_t tile = 0 ) {
+	return clip_polygon( polygon.begin( ), polygon.end( ), rect, out, tile );
+}
+
+
+////////////////////////////////////////
+// Cut a polygon into the tiles of a grid
+//   grid is split into columns x rows tiles, numbered row by row from
+//   ( grid.l, grid.t ); appends a piece for every tile the polygon covers
+//   and returns how many
+
+template<typename ForwardIt, typename T>
+std::size_t tile_polygon( ForwardIt first, ForwardIt last, const rect2<T>& grid,
+                          std::size_t columns, std::size_t rows, clip_buffer<T>& out ) {
+	if( std::distance( first, last ) < 3 || columns == 0 || rows == 0 ) { return 0; }
+
+	const T width  = grid.width( ) / T(columns);
+	const T height = grid.height( ) / T(rows);
+	const rect2<T> box = detail::clip::bounds<ForwardIt,T>( first, last );
+
+	std::size_t c0, c1, r0, r1;
+	if( !detail::clip::cells( box.l, box.r, grid.l, width, columns, c0, c1 ) ||
+	    !detail::clip::cells( box.t, box.b, grid.t, height, rows, r0, r1 ) ) {
+		return 0;
+	}
+	if( c0 == c1 && r0 == r1 ) {
+		rect2<T> cell;
+		cell.l = detail::clip::line( grid.l, grid.r, width, c0, columns );
+		cell.r = detail::clip::line( grid.l, grid.r, width, c0 + 1, columns );
+		cell.t = detail::clip::line( grid.t, grid.b, height, r0, rows );
+		cell.b = detail::clip::line( grid.t, grid.b, height, r0 + 1, rows );
+		return clip_polygon( first, last, cell, out, r0 * columns + c0 ) ? 1 : 0;
+	}
+
+	std::vector<point2<T>>& rest   = out.m_scratch[0];  // right of the columns done
+	std::vector<point2<T>>& column = out.m_scratch[1];
+	std::vector<point2<T>>& piece  = out.m_scratch[2];
+	std::vector<point2<T>>& below  = out.m_scratch[3];  // below the rows done
+
+	// trim to the grid first, what is left fits between its sides
+	rest.clear( );
+	rect2<T> span;
+	span.l = detail::clip::line( grid.l, grid.r, width, c0, columns );
+	span.r = detail::clip::line( grid.l, grid.r, width, c1 + 1, columns );
+	span.t = detail::clip::line( grid.t, grid.b, height, r0, rows );
+	span.b = detail::clip::line( grid.t, grid.b, height, r1 + 1, rows );
+	detail::clip::pipeline<T,std::vector<point2<T>>> stages( span, rest );
+	for( ; first != last; ++first ) { stages.push( 0, *first ); }
+	stages.finish( );
+
+	const std::size_t before = out.size( );
+	for( std::size_t c = c0; c <= c1 && rest.size( ) >= 3; ++c ) {
+		if( c < c1 ) {
+			detail::clip::split( rest, 0, detail::clip::line( grid.l, grid.r, width, c + 1, columns ),
+			                     column, piece );
+			rest.swap( piece );
+		}
+		else {
+			column.swap( rest );
+			rest.clear( );
+		}
+		if( column.size( ) < 3 ) { continue; }
+
+		// the rows this column reaches
+		T top = column[0].y( ), bottom = top;
+		for( const point2<T>& pt : column ) {
+			top    = std::min( top, pt.y( ) );
+			bottom = std::max( bottom, pt.y( ) );
+		}
+		std::size_t s0, s1;
+		if( !detail::clip::cells( top, bottom, grid.t, height, rows, s0, s1 ) ) { continue; }
+
+		for( std::size_t r = s0; r <= s1 && column.size( ) >= 3; ++r ) {
+			if( r < s1 ) {
+				detail::clip::split( column, 1, detail::clip::line( grid.t, grid.b, height, r + 1, rows ),
+				                     piece, below );
+				column.swap( below );
+			}
+			else {
+				piece.swap( column );
+				column.clear( );
+			}
+			for( const point2<T>& pt : piece ) { out.push_back( pt ); }
+			out.close_piece( r * columns + c );
+		}
+	}
+	return out.size( ) - before;
+}
+
+template<typename T>
+std::size_t tile_polygon( const std::vector<point2<T>>& polygon, const rect2<T>& grid,
+                          std::size_t columns, std::size_t rows, clip_buffer<T>& out ) {
+	return tile_polygon( polygon.begin( ), polygon.end( ), grid, columns, rows, out );
+}
+
+
+////////////////////////////////////////
+// Clip a segment to a rect
+//   the part inside is seg.base_point( ) + t seg.base_vector( ) for t in
+//   [ t0, t1 ], false if there is none; a segment that is wholly inside
+//   or wholly to one side of the rect is settled from its ends alone
+
+template<typename T>
+bool clip_segment( const segment2<T>& seg, const rect2<T>& rect, T& t0, T& t1 ) {
+	const T px = seg.base_point( )[0], py = seg.base_point( )[1];
+	const T vx = seg.base_vector( )[0], vy = seg.base_vector( )[1];
+	const T qx = px + vx, qy = py + vy;
+
+	t0 = T(0);
+	t1 = T(1);
+	if( ( px < rect.l && qx < rect.l ) || ( px > rect.r && qx > rect.r ) ||
+	    ( py < rect.t && qy < rect.t ) || ( py > rect.b && qy > rect.b ) ) {
+		return false;
+	}
+	if( px >= rect.l && px <= rect.r && qx >= rect.l && qx <= rect.r &&
+	    py >= rect.t && py <= rect.b && qy >= rect.t && qy <= rect.b ) {
+		return true;
+	}
+	return detail::clip::liang_barsky( px, py, vx, vy, rect, t0, t1 );
+}
+
+template<typename T>
+bool clip_segment( const segment2<T>& seg, const rect2<T>& rect, segment2<T>& result ) {
+	T t0, t1;
+	if( !clip_segment( seg, rect, t0, t1 ) ) { return false; }
+	if( t0 == T(0) && t1 == T(1) ) {
+		result = seg;
+		return true;
+	}
+	const point2<T>&  p = seg.base_point( );
+	const vector2<T>& v = seg.base_vector( );
+	result = segment2<T>( point2<T>( p[0] + t0 * v[0], p[1] + t0 * v[1] ),
+	                      vector2<T>( ( t1 - t0 ) * v[0], ( t1 - t0 ) * v[1] ) );
+	return true;
+}
+
+// The part of a line inside a rect, as a segment in the line's direction
+//   false if it misses, or if the line has no direction
+template<typename T>
+bool clip_line( const line2<T>& ln, const rect2<T>& rect, segment2<T>& result ) {
+	const point2<T>&  p = ln.base_point( );
+	const vector2<T>& v = ln.base_vector( );
+	if( v[0] == T(0) && v[1] == T(0) ) { return false; }
+
+	T t0 = -std::numeric_limits<T>::infinity( );
+	T t1 =  std::numeric_limits<T>::infinity( );
+	if( !detail::clip::liang_barsky( p[0], p[1], v[0], v[1], rect, t0, t1 ) ) { return false; }
+	result = segment2<T>( point2<T>( p[0] + t0 * v[0], p[1] + t0 * v[1] ),
+	                      vector2<T>( ( t1 - t0 ) * v[0], ( t1 - t0 ) * v[1] ) );
+	return true;
+}
+
+
+////////////////////////////////////////
+// Clip columns of segments to a rect
+//   segment i is ( px[i], py[i] ) + t ( vx[i], vy[i] ) for t in [ 0, 1 ],
+//   the same form as segment_block; its part inside is t in
+//   [ t0[i], t1[i] ], and it misses when t0[i] > t1[i].  Returns how many
+//   do not miss.  There are no branches, so the compiler vectorizes it.
+
+template<typename T>
+std::size_t clip_segments( const T* px, const T* py, const T* vx, const T* vy, std::size_t count,
+                           const rect2<T>& rect, T* t0, T* t1 ) {
+	std::size_t inside = 0;
+	for( std::size_t i = 0; i < count; ++i ) {
+		T enter = T(0), exit = T(1);
+		detail::clip::slab( px[i], vx[i], rect.l, rect.r, enter, exit );
+		detail::clip::slab( py[i], vy[i], rect.t, rect.b, enter, exit );
+		t0[i] = enter;
+		t1[i] = exit;
+		inside += ( enter <= exit );
+	}
+	return inside;
+}
+
+}  // End namespace euclib
+
+#endif // EUBLIB_CLIP_HPP
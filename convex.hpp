@@ -0,0 +1,652 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_CONVEX_HPP
+#define EUBLIB_CONVEX_HPP
+
+#include <cstddef>	// for std::size_t
+#include <cmath>
+#include <array>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <cassert>
+
+#include "point.hpp"
+#include "vector.hpp"
+#include "segment.hpp"
+#include "predicates.hpp"
+#include "hull.hpp"
+
+/*
+ * Operations on convex polygons
+ *
+ *   Every polygon here is a range of vertices in the order convex_hull( )
+ *   leaves them: counterclockwise, no duplicate and no collinear vertices.
+ *   Ranges of one or two vertices are a point or a segment.  Nothing
+ *   allocates, results are written to caller provided storage.
+ *
+ *   The decisions are made with the exact predicates, only the coordinates
+ *   of new points (where two edges cross) are rounded.
+ */
+
+namespace euclib {
+
+namespace detail { namespace convex {
+
+	// float sums of products lose too much, see polygon2::calc_metrics( )
+	template<typename T>
+	struct accumulator {
+		typedef typename std::conditional<std::is_same<T,float>::value,
+		                                  double, T>::type type;
+	};
+
+	// a + t * ( b - a ), exact at t = 0 and t = 1
+	template<typename T, typename A>
+	inline point2<T> lerp( const point2<T>& a, const point2<T>& b, A t ) {
+		if( t == A(0) ) { return a; }
+		if( t == A(1) ) { return b; }
+		return point2<T>( static_cast<T>( a.x( ) + t * ( A( b.x( ) ) - a.x( ) ) ),
+		                  static_cast<T>( a.y( ) + t * ( A( b.y( ) ) - a.y( ) ) ) );
+	}
+
+	enum class crossing { none, proper, vertex, overlap };
+
+	// Collinear segments ab and cd, compared along the axis ab (or cd)
+	//   varies most on; p, q is the shared part in the direction of ab
+	template<typename T>
+	crossing collinear_overlap( const point2<T>& a, const point2<T>& b,
+	                            const point2<T>& c, const point2<T>& d,
+	                            point2<T>& p, point2<T>& q ) {
+		if( same_point( a, b ) && same_point( c, d ) ) {
+			if( !same_point( a, c ) ) { return crossing::none; }
+			p = a;
+			return crossing::vertex;
+		}
+		const point2<T>& u = same_point( a, b ) ? c : a;
+		const point2<T>& v = same_point( a, b ) ? d : b;
+		using std::abs;
+		const std::size_t axis = abs( v.x( ) - u.x( ) ) >= abs( v.y( ) - u.y( ) ) ? 0 : 1;
+
+		// orient both along the axis, then the overlap is [lo, hi]
+		const bool ab_up = a[axis] <= b[axis];
+		const point2<T>& a0 = ab_up ? a : b;
+		const point2<T>& a1 = ab_up ? b : a;
+		const point2<T>& c0 = c[axis] <= d[axis] ? c : d;
+		const point2<T>& c1 = c[axis] <= d[axis] ? d : c;
+		const point2<T>& lo = a0[axis] >= c0[axis] ? a0 : c0;
+		const point2<T>& hi = a1[axis] <= c1[axis] ? a1 : c1;
+
+		if( lo[axis] > hi[axis] ) { return crossing::none; }
+		if( lo[axis] == hi[axis] ) {
+			p = lo;
+			return crossing::vertex;
+		}
+		p = ab_up ? lo : hi;
+		q = ab_up ? hi : lo;
+		return crossing::overlap;
+	}
+
+	// How segments ab and cd meet, p is set unless there is no contact
+	//   and q as well for an overlap; a point is a segment with a == b
+	template<typename T>
+	crossing segment_intersection( const point2<T>& a, const point2<T>& b,
+	                               const point2<T>& c, const point2<T>& d,
+	                               point2<T>& p, point2<T>& q ) {
+		typedef typename accumulator<T>::type accum_t;
+
+		const T abc = orient2d( a, b, c ), abd = orient2d( a, b, d );
+		const T cda = orient2d( c, d, a ), cdb = orient2d( c, d, b );
+		if( ( abc > T(0) && abd > T(0) ) || ( abc < T(0) && abd < T(0) ) ||
+		    ( cda > T(0) && cdb > T(0) ) || ( cda < T(0) && cdb < T(0) ) ) {
+			return crossing::none;
+		}
+
+		if( ( abc == T(0) && abd == T(0) ) || ( cda == T(0) && cdb == T(0) ) ) {
+			return collinear_overlap( a, b, c, d, p, q );
+		}
+		if( cda == T(0) ) { p = a; return crossing::vertex; }
+		if( cdb == T(0) ) { p = b; return crossing::vertex; }
+		if( abc == T(0) ) { p = c; return crossing::vertex; }
+		if( abd == T(0) ) { p = d; return crossing::vertex; }
+
+		p = lerp( a, b, accum_t( cda ) / ( accum_t( cda ) - cdb ) );
+		return crossing::proper;
+	}
+
+	// On or inside the polygon, O(n)
+	template<typename RandomIt, typename T>
+	bool contains( RandomIt first, std::size_t n, const point2<T>& pt ) {
+		for( std::size_t i = 0, j = n - 1; i < n; j = i++ ) {
+			if( orient2d( first[j], first[i], pt ) < T(0) ) { return false; }
+		}
+		return true;
+	}
+
+	// Writes the polygon vertices in order, dropping repeats, and stops
+	//   once the boundary comes back around to the first one
+	template<typename T>
+	struct boundary_writer {
+		point2<T>*  out;
+		std::size_t count;
+		std::size_t capacity;
+		bool        closed;
+
+		boundary_writer( point2<T>* out, std::size_t capacity ) :
+			out( out ), count( 0 ), capacity( capacity ), closed( false ) { }
+
+		void push( const point2<T>& pt ) {
+			if( count > 0 && same_point( pt, out[count-1] ) ) { return; }
+			if( count > 1 && same_point( pt, out[0] ) ) { closed = true; return; }
+			assert( count < capacity );
+			if( count == capacity ) { closed = true; return; }
+			out[count++] = pt;
+		}
+	};
+
+	// Drops vertices that sit on the line through their neighbours,
+	//   which degenerate contacts can leave behind
+	template<typename T>
+	point2<T>* remove_collinear( point2<T>* first, point2<T>* last ) {
+		std::size_t k = 0;
+		for( point2<T>* itr = first; itr != last; ++itr ) {
+			while( k >= 2 && orient2d( first[k-2], first[k-1], *itr ) == T(0) ) { --k; }
+			first[k++] = *itr;
+		}
+		while( k >= 3 && orient2d( first[k-2], first[k-1], first[0] ) == T(0) ) { --k; }
+		std::size_t start = 0;
+		while( k - start >= 3 && orient2d( first[k-1], first[start], first[start+1] ) == T(0) ) {
+			++start;
+		}
+		std::copy( first + start, first + k, first );
+		return first + ( k - start );
+	}
+
+	// A point or segment against a polygon of at least 3 vertices,
+	//   clipped parametrically to the inside of every edge
+	template<typename RandomIt, typename T>
+	point2<T>* clip_segment( const point2<T>& a, const point2<T>& b,
+	                         RandomIt poly, std::size_t n, point2<T>* out ) {
+		typedef typename accumulator<T>::type accum_t;
+
+		accum_t t0 = 0, t1 = 1;
+		for( std::size_t i = 0, j = n - 1; i < n; j = i++ ) {
+			const T da = orient2d( poly[j], poly[i], a );
+			const T db = orient2d( poly[j], poly[i], b );
+			if( da < T(0) && db < T(0) ) { return out; }
+			if( da < T(0) ) { t0 = std::max( t0, accum_t( da ) / ( accum_t( da ) - db ) ); }
+			if( db < T(0) ) { t1 = std::min( t1, accum_t( da ) / ( accum_t( da ) - db ) ); }
+		}
+		if( t0 > t1 ) { return out; }
+
+		*out++ = lerp( a, b, t0 );
+		if( t1 > t0 ) { *out++ = lerp( a, b, t1 ); }
+		return out;
+	}
+
+	// Twice the area
+	template<typename RandomIt>
+	auto area2( RandomIt first, std::size_t n ) {
+		typedef typename std::iterator_traits<RandomIt>::value_type::value_t T;
+		typedef typename accumulator<T>::type accum_t;
+		accum_t area = 0;
+		for( std::size_t i = 0, j = n - 1; i < n; j = i++ ) {
+			area += accum_t( first[j].x( ) ) * first[i].y( ) - accum_t( first[i].x( ) ) * first[j].y( );
+		}
+		return area;
+	}
+
+	// Boundaries that never cross, so one contains the other or they
+	//   are disjoint apart from the contact points already written
+	template<typename RandomIt1, typename RandomIt2, typename T>
+	point2<T>* nested( RandomIt1 p, std::size_t n, RandomIt2 q, std::size_t m,
+	                   point2<T>* out, point2<T>* touching ) {
+		// the centroid of three vertices is strictly inside
+		auto inner = []( auto poly ) {
+			return point2<T>( ( poly[0].x( ) + poly[1].x( ) + poly[2].x( ) ) / 3,
+			                  ( poly[0].y( ) + poly[1].y( ) + poly[2].y( ) ) / 3 );
+		};
+		const bool q_in_p = contains( p, n, inner( q ) );
+		const bool p_in_q = contains( q, m, inner( p ) );
+
+		// both only when one holds the other, the smaller is the overlap
+		if( q_in_p && p_in_q ) {
+			if( area2( q, m ) <= area2( p, n ) ) { return std::copy( q, q + m, out ); }
+			return std::copy( p, p + n, out );
+		}
+		if( q_in_p ) { return std::copy( q, q + m, out ); }
+		if( p_in_q ) { return std::copy( p, p + n, out ); }
+		return touching;
+	}
+
+	// A polygon read cyclically from its lowest-leftmost vertex, or
+	//   negated and read from the vertex that becomes lowest-leftmost
+	template<typename RandomIt>
+	class cyclic_view {
+		typedef typename std::iterator_traits<RandomIt>::value_type point_t;
+
+		RandomIt    m_first;
+		std::size_t m_size;
+		std::size_t m_start;
+		bool        m_negate;
+
+	public:
+		cyclic_view( RandomIt first, RandomIt last, bool negate ) :
+			m_first( first ), m_size( std::distance( first, last ) ), m_start( 0 ), m_negate( negate ) {
+			if( m_size == 0 ) { return; }
+			m_start = ( negate ? std::max_element( first, last, lexicographic_less( ) )
+			                   : std::min_element( first, last, lexicographic_less( ) ) ) - first;
+		}
+
+		std::size_t size( ) const { return m_size; }
+
+		// i < 2 * size( )
+		point_t operator [] ( std::size_t i ) const {
+			i += m_start;
+			while( i >= m_size ) { i -= m_size; }
+			const point_t& pt = m_first[i];
+			return m_negate ? point_t( -pt.x( ), -pt.y( ) ) : pt;
+		}
+	};
+
+	// Both polygons start at their vertex extreme in the same direction,
+	//   so their edges can be merged by angle like two sorted lists
+	template<typename ViewP, typename ViewQ, typename T>
+	point2<T>* minkowski_merge( const ViewP& p, const ViewQ& q, point2<T>* out ) {
+		const std::size_t n = p.size( );
+		const std::size_t m = q.size( );
+		if( n == 0 || m == 0 ) { return out; }
+
+		auto add = []( const point2<T>& a, const point2<T>& b ) {
+			return point2<T>( a.x( ) + b.x( ), a.y( ) + b.y( ) );
+		};
+
+		// a point only moves the other polygon
+		if( n == 1 ) {
+			for( std::size_t j = 0; j < m; ++j ) { *out++ = add( p[0], q[j] ); }
+			return out;
+		}
+		if( m == 1 ) {
+			for( std::size_t i = 0; i < n; ++i ) { *out++ = add( p[i], q[0] ); }
+			return out;
+		}
+
+		// parallel edges are taken together, so no vertex is collinear
+		std::size_t i = 0, j = 0;
+		while( i < n || j < m ) {
+			*out++ = add( p[i], q[j] );
+			const T turn = ( i == n ) ? T(-1)
+			             : ( j == m ) ? T(1)
+			             : turn2d( p[i], p[i+1], q[j], q[j+1] );
+			if( turn >= T(0) ) { ++i; }
+			if( turn <= T(0) ) { ++j; }
+		}
+		return out;
+	}
+
+} } // End namespace detail::convex
+
+
+////////////////////////////////////////
+// Intersection of two convex polygons
+//   O'Rourke, Chien, Olson and Naddor's edge chase, O(n + m)
+//
+//   The edges of both polygons are advanced in step, always moving the one
+//   that is aiming at the other's edge, so that each pair of edges that can
+//   cross is visited once.  Vertices are written as the inner chain of the
+//   two boundaries is walked.
+//
+//   out must have room for ( p_last - p_first ) + ( q_last - q_first ) points,
+//   returns the end of the result; the result is counterclockwise but
+//   starts wherever the boundaries first meet.  Touching polygons give a
+//   point or a segment.
+
+template<typename RandomIt1, typename RandomIt2, typename T>
+point2<T>* convex_intersection( RandomIt1 p_first, RandomIt1 p_last,
+                                RandomIt2 q_first, RandomIt2 q_last, point2<T>* out ) {
+	using namespace detail::convex;
+
+	const std::size_t n = std::distance( p_first, p_last );
+	const std::size_t m = std::distance( q_first, q_last );
+	if( n == 0 || m == 0 ) { return out; }
+
+	// points and segments
+	if( n < 3 && m < 3 ) {
+		point2<T> p, q;
+		switch( segment_intersection( p_first[0], p_first[n-1], q_first[0], q_first[m-1], p, q ) ) {
+			case crossing::none:    return out;
+			case crossing::overlap: *out++ = p; *out++ = q; return out;
+			default:                *out++ = p; return out;
+		}
+	}
+	if( n < 3 ) { return clip_segment( p_first[0], p_first[n-1], q_first, m, out ); }
+	if( m < 3 ) { return clip_segment( q_first[0], q_first[m-1], p_first, n, out ); }
+
+	enum class inside { unknown, p, q };
+	inside flag = inside::unknown;
+	point2<T> contact;
+	bool touched = false;
+	boundary_writer<T> writer( out, n + m );
+
+	// a and b are the heads of the current edges,
+	//   aa and ba count the advances made on each
+	std::size_t a = 0, b = 0, aa = 0, ba = 0;
+	auto advance_a = [&]( ) {
+		if( flag == inside::p ) { writer.push( p_first[a] ); }
+		a = ( a + 1 == n ) ? 0 : a + 1;
+		++aa;
+	};
+	auto advance_b = [&]( ) {
+		if( flag == inside::q ) { writer.push( q_first[b] ); }
+		b = ( b + 1 == m ) ? 0 : b + 1;
+		++ba;
+	};
+
+	do {
+		const point2<T>& pa  = p_first[a];
+		const point2<T>& pa1 = p_first[a == 0 ? n - 1 : a - 1];
+		const point2<T>& qb  = q_first[b];
+		const point2<T>& qb1 = q_first[b == 0 ? m - 1 : b - 1];
+
+		const T cross = turn2d( pa1, pa, qb1, qb );
+		const T a_in_b = orient2d( qb1, qb, pa );   // head of a against edge b
+		const T b_in_a = orient2d( pa1, pa, qb );   // head of b against edge a
+
+		point2<T> p, q;
+		const crossing code = segment_intersection( qb1, qb, pa1, pa, p, q );
+		if( code == crossing::proper || code == crossing::vertex ) {
+			const inside next = a_in_b > T(0) ? inside::p
+			                  : b_in_a > T(0) ? inside::q : flag;
+			// a contact that does not tell which side is inside is only
+			//   kept in case the boundaries turn out to just touch there
+			if( next == inside::unknown ) {
+				if( !touched ) { contact = p; touched = true; }
+			}
+			else {
+				// counting starts over at the first real crossing
+				if( flag == inside::unknown ) { aa = ba = 0; }
+				writer.push( p );
+			}
+			flag = next;
+		}
+
+		// edges lying on each other, pointing opposite ways,
+		//   the polygons only share that segment
+		if( code == crossing::overlap &&
+		    ( pa.x( ) - pa1.x( ) ) * ( qb.x( ) - qb1.x( ) ) +
+		    ( pa.y( ) - pa1.y( ) ) * ( qb.y( ) - qb1.y( ) ) < T(0) ) {
+			*out++ = p;
+			*out++ = q;
+			return out;
+		}
+
+		if( cross == T(0) && a_in_b < T(0) && b_in_a < T(0) ) {
+			return out;  // parallel edges facing away, disjoint
+		}
+		else if( cross == T(0) && a_in_b == T(0) && b_in_a == T(0) ) {
+			// collinear, step past the overlap without writing
+			if( flag == inside::p ) { advance_b( ); }
+			else                    { advance_a( ); }
+		}
+		else if( cross >= T(0) ) {
+			if( b_in_a > T(0) ) { advance_a( ); }
+			else                { advance_b( ); }
+		}
+		else {
+			if( a_in_b > T(0) ) { advance_b( ); }
+			else                { advance_a( ); }
+		}
+	} while( !writer.closed && ( aa < n || ba < m ) && aa < 2*n && ba < 2*m );
+
+	if( flag == inside::unknown ) {
+		if( touched ) { *out = contact; }
+		return nested( p_first, n, q_first, m, out, out + ( touched ? 1 : 0 ) );
+	}
+	return remove_collinear( out, out + writer.count );
+}
+
+
+
+////////////////////////////////////////
+// Minkowski sum of two convex polygons, O(n + m)
+//
+//   Every edge of the sum is an edge of one of the polygons, in order of
+//   angle, so the two edge sequences are merged instead of hulling all
+//   n * m pairwise sums.
+//
+//   out must have room for ( p_last - p_first ) + ( q_last - q_first )
+//   points, returns the end of the result; the result is in the order
+//   convex_hull( ) leaves a hull.
+
+template<typename RandomIt1, typename RandomIt2, typename T>
+point2<T>* minkowski_sum( RandomIt1 p_first, RandomIt1 p_last,
+                          RandomIt2 q_first, RandomIt2 q_last, point2<T>* out ) {
+	using namespace detail::convex;
+	return minkowski_merge( cyclic_view<RandomIt1>( p_first, p_last, false ),
+	                        cyclic_view<RandomIt2>( q_first, q_last, false ), out );
+}
+
+// The sum of p and q reflected through the origin, { a - b : a in p, b in q },
+//   which holds the origin exactly when the polygons overlap
+template<typename RandomIt1, typename RandomIt2, typename T>
+point2<T>* minkowski_difference( RandomIt1 p_first, RandomIt1 p_last,
+                                 RandomIt2 q_first, RandomIt2 q_last, point2<T>* out ) {
+	using namespace detail::convex;
+	return minkowski_merge( cyclic_view<RandomIt1>( p_first, p_last, false ),
+	                        cyclic_view<RandomIt2>( q_first, q_last, true ), out );
+}
+
+
+
+////////////////////////////////////////
+// Rotating calipers
+//
+//   Each edge in turn is laid against a caliper and the vertices extreme
+//   relative to it are tracked by pointers that only ever move forward, so
+//   a whole sweep is O(n).  The polygon must be a hull (see the top of the
+//   file); one or two vertices are a point or a segment.
+
+// A rectangle at any angle
+template<typename T>
+struct oriented_rect2 {
+	point2<T>  center;
+	vector2<T> axis[2];    // unit length, axis[1] is axis[0] turned counterclockwise
+	T          extent[2];  // half the length of the sides along each axis
+
+	T area( ) const { return 4 * extent[0] * extent[1]; }
+
+	// counterclockwise, starting from the corner least along both axes
+	std::array<point2<T>,4> corners( ) const {
+		std::array<point2<T>,4> result;
+		const T sign[4][2] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+		for( std::size_t k = 0; k < 4; ++k ) {
+			const T s0 = sign[k][0] * extent[0], s1 = sign[k][1] * extent[1];
+			result[k] = point2<T>( center.x( ) + s0 * axis[0].x( ) + s1 * axis[1].x( ),
+			                       center.y( ) + s0 * axis[0].y( ) + s1 * axis[1].y( ) );
+		}
+		return result;
+	}
+};
+
+namespace detail { namespace convex {
+
+	// ( b - a ) . ( d - c )
+	template<typename T>
+	inline typename accumulator<T>::type dot( const point2<T>& a, const point2<T>& b,
+	                                          const point2<T>& c, const point2<T>& d ) {
+		typedef typename accumulator<T>::type accum_t;
+		return ( accum_t( b.x( ) ) - a.x( ) ) * ( accum_t( d.x( ) ) - c.x( ) ) +
+		       ( accum_t( b.y( ) ) - a.y( ) ) * ( accum_t( d.y( ) ) - c.y( ) );
+	}
+
+	template<typename T>
+	inline typename accumulator<T>::type distance_sq( const point2<T>& a, const point2<T>& b ) {
+		typedef typename accumulator<T>::type accum_t;
+		const accum_t dx = accum_t( b.x( ) ) - a.x( ), dy = accum_t( b.y( ) ) - a.y( );
+		return dx * dx + dy * dy;
+	}
+
+	inline std::size_t next( std::size_t i, std::size_t n ) { return i + 1 == n ? 0 : i + 1; }
+
+	// moves k forward while the edge from it turns towards edge ab,
+	//   which leaves k at the vertex furthest from the line ab
+	template<typename RandomIt>
+	inline std::size_t furthest( RandomIt poly, std::size_t n, std::size_t a, std::size_t k ) {
+		const std::size_t b = next( a, n );
+		for( std::size_t steps = 0; steps < n; ++steps ) {
+			const std::size_t k1 = next( k, n );
+			if( turn2d( poly[a], poly[b], poly[k], poly[k1] ) <= 0 ) { break; }
+			k = k1;
+		}
+		return k;
+	}
+
+} } // End namespace detail::convex
+
+// The two vertices furthest apart, from the antipodal pairs
+template<typename RandomIt>
+auto convex_diameter( RandomIt first, RandomIt last ) {
+	using namespace detail::convex;
+	typedef typename std::iterator_traits<RandomIt>::value_type point_t;
+	typedef segment<typename point_t::value_t,2>                segment_t;
+
+	const std::size_t n = std::distance( first, last );
+	if( n == 0 ) { return segment_t( ); }
+	if( n < 3 )  { return segment_t( first[0], first[n-1] ); }
+
+	std::size_t best_a = 0, best_b = 0;
+	auto best = distance_sq( first[0], first[0] );
+	std::size_t k = 1;
+	for( std::size_t a = 0; a < n; ++a ) {
+		k = furthest( first, n, a, k );
+		// k is antipodal to both ends of the edge
+		const std::size_t b = next( a, n );
+		if( distance_sq( first[a], first[k] ) > best ) {
+			best = distance_sq( first[a], first[k] );
+			best_a = a;  best_b = k;
+		}
+		if( distance_sq( first[b], first[k] ) > best ) {
+			best = distance_sq( first[b], first[k] );
+			best_a = b;  best_b = k;
+		}
+	}
+	return segment_t( first[best_a], first[best_b] );
+}
+
+// The smallest distance between two parallel lines enclosing the
+//   polygon, one of them is always through an edge
+template<typename RandomIt>
+auto convex_width( RandomIt first, RandomIt last ) {
+	using namespace detail::convex;
+	typedef typename std::iterator_traits<RandomIt>::value_type::value_t T;
+	typedef typename accumulator<T>::type                               accum_t;
+
+	const std::size_t n = std::distance( first, last );
+	if( n < 3 ) { return T(0); }
+
+	accum_t best = 0;
+	std::size_t k = 1;
+	for( std::size_t a = 0; a < n; ++a ) {
+		k = furthest( first, n, a, k );
+		const std::size_t b = next( a, n );
+		using std::sqrt;
+		const accum_t height = accum_t( orient2d( first[a], first[b], first[k] ) ) /
+		                       sqrt( distance_sq( first[a], first[b] ) );
+		if( a == 0 || height < best ) { best = height; }
+	}
+	return static_cast<T>( best );
+}
+
+// The smallest rectangle around the polygon, which has a side
+//   along one of the edges (Freeman and Shapira)
+template<typename RandomIt>
+auto min_area_rect( RandomIt first, RandomIt last ) {
+	using namespace detail::convex;
+	typedef typename std::iterator_traits<RandomIt>::value_type::value_t T;
+	typedef typename accumulator<T>::type                               accum_t;
+
+	oriented_rect2<T> result;
+	result.axis[0] = vector2<T>( T(1), T(0) );
+	result.axis[1] = vector2<T>( T(0), T(1) );
+	result.extent[0] = result.extent[1] = T(0);
+
+	const std::size_t n = std::distance( first, last );
+	if( n == 0 ) { return result; }
+	if( n < 3 ) {
+		const point2<T>& a = first[0];
+		const point2<T>& b = first[n-1];
+		const accum_t length = std::sqrt( distance_sq( a, b ) );
+		result.center = point2<T>( ( a.x( ) + b.x( ) ) / 2, ( a.y( ) + b.y( ) ) / 2 );
+		if( length > accum_t(0) ) {
+			result.axis[0] = vector2<T>( static_cast<T>( ( b.x( ) - a.x( ) ) / length ),
+			                             static_cast<T>( ( b.y( ) - a.y( ) ) / length ) );
+			result.axis[1] = vector2<T>( -result.axis[0].y( ), result.axis[0].x( ) );
+			result.extent[0] = static_cast<T>( length / 2 );
+		}
+		return result;
+	}
+
+	// right, top and left are the vertices furthest along the edge,
+	//   away from it and back against it
+	std::size_t right = 1, top = 1, left = 1;
+	accum_t best_area = 0;
+	for( std::size_t a = 0; a < n; ++a ) {
+		const std::size_t b = next( a, n );
+		const point2<T>& pa = first[a];
+		const point2<T>& pb = first[b];
+
+		if( a == 0 ) { right = b; }
+		for( std::size_t steps = 0; steps < n && dot( pa, pb, first[right], first[next( right, n )] ) > 0; ++steps ) {
+			right = next( right, n );
+		}
+		if( a == 0 ) { top = right; }
+		top = furthest( first, n, a, top );
+		if( a == 0 ) { left = top; }
+		for( std::size_t steps = 0; steps < n && dot( pa, pb, first[left], first[next( left, n )] ) < 0; ++steps ) {
+			left = next( left, n );
+		}
+
+		// everything in units of the edge length squared
+		const accum_t length_sq = distance_sq( pa, pb );
+		const accum_t lo = dot( pa, pb, pa, first[left] );
+		const accum_t hi = dot( pa, pb, pa, first[right] );
+		const accum_t height = orient2d( pa, pb, first[top] );
+		const accum_t area = ( hi - lo ) * height / length_sq;
+		if( a == 0 || area < best_area ) {
+			best_area = area;
+
+			using std::sqrt;
+			const accum_t length = sqrt( length_sq );
+			const accum_t ux = ( accum_t( pb.x( ) ) - pa.x( ) ) / length;
+			const accum_t uy = ( accum_t( pb.y( ) ) - pa.y( ) ) / length;
+			const accum_t along = ( lo + hi ) / ( 2 * length );
+			const accum_t up = height / ( 2 * length );
+			result.center = point2<T>( static_cast<T>( pa.x( ) + ux * along - uy * up ),
+			                           static_cast<T>( pa.y( ) + uy * along + ux * up ) );
+			result.axis[0] = vector2<T>( static_cast<T>( ux ), static_cast<T>( uy ) );
+			result.axis[1] = vector2<T>( static_cast<T>( -uy ), static_cast<T>( ux ) );
+			result.extent[0] = static_cast<T>( ( hi - lo ) / ( 2 * length ) );
+			result.extent[1] = static_cast<T>( up );
+		}
+	}
+	return result;
+}
+
+}  // End namespace euclib
+
+#endif // EUBLIB_CONVEX_HPP
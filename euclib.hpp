@@ -22,7 +22,17 @@
 #include "angle.hpp"
 #include "point.hpp"
 #include "vector.hpp"
+#include "point_cloud.hpp"
 #include "line.hpp"
 #include "segment.hpp"
+#include "predicates.hpp"
+#include "hull.hpp"
+#include "convex.hpp"
+#include "gjk.hpp"
+#include "simple_polygon.hpp"
+#include "clip.hpp"
+#include "simplify.hpp"
+#include "intersection.hpp"
+#include "spatial_hash.hpp"
 
 #endif // EUBLIB_HPP
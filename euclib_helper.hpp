@@ -25,6 +25,11 @@
 #include "segment.hpp"
 #include "rect.hpp"
 #include "polygon.hpp"
+#include "predicates.hpp"
+#include "convex.hpp"
+#include "gjk.hpp"
+#include "intersection.hpp"
+#include "clip.hpp"
 
 #include <vector>
 #include <complex>
@@ -80,7 +85,7 @@ const float RADIANS = PI / 180.f;
 
 	template<typename T> inline
 	point2<T> translate( const point2<T>& pt, T x, T y ) {
-		return point2<T>{ pt.x + x, pt.y + y };
+		return point2<T>{ pt.x( ) + x, pt.y( ) + y };
 	}
 
 	template<typename T> inline
@@ -109,7 +114,7 @@ const float RADIANS = PI / 180.f;
 		   ) {
 			*itr = translate( *itr, x, y );
 		}
-		new_poly.m_bounding_box = translate( new_poly.m_bounding_box, x, y );
+		new_poly.hull_changed( );
 		return new_poly;
 	}
 
@@ -123,32 +128,21 @@ const float RADIANS = PI / 180.f;
 	template<typename T>
 	point2<T> rotate( const point2<T>& target, const point2<T>& about,
 	                   float angle, bool clockwise = true ) {
-	    // get translation matrix
-		float matrix[4] = { std::cos(angle*RADIANS), -std::sin(angle*RADIANS),
-		                    std::sin(angle*RADIANS), std::cos(angle*RADIANS) };
+	    // get rotation matrix
+		const T radians = static_cast<T>( angle ) * static_cast<T>( RADIANS );
+		T matrix[4] = { std::cos( radians ), -std::sin( radians ),
+		                std::sin( radians ), std::cos( radians ) };
 		if( !clockwise ) {
-			matrix[1] *= -1.f;
-			matrix[3] *= -1.f;
+			matrix[1] = -matrix[1];
+			matrix[2] = -matrix[2];
 		}
 
 		// translate 'about' to origin
-		point2<T> tmp = translate( target, -about.x, -about.y );
+		point2<T> tmp = translate( target, -about.x( ), -about.y( ) );
 
-		point2f rotated = { ( matrix[0]*static_cast<float>(tmp.x) +
-		                      matrix[1]*static_cast<float>(tmp.y) ),
-		                    ( matrix[2]*static_cast<float>(tmp.x) +
-		                      matrix[3]*static_cast<float>(tmp.y) ) };
-
-		// reduce rounding errors
-		if( std::numeric_limits<T>::is_integer ) {
-			rotated.x += 0.5f;
-			rotated.y += 0.5f;
-		}
-
-		// translate back
-		return translate( point2<T>{ static_cast<T>(rotated.x),
-		                             static_cast<T>(rotated.y) },
-		                  about.x, about.y );
+		// rotate and translate back
+		return point2<T>{ matrix[0]*tmp.x( ) + matrix[1]*tmp.y( ) + about.x( ),
+		                  matrix[2]*tmp.x( ) + matrix[3]*tmp.y( ) + about.y( ) };
 	}
 
 	template<typename T> inline
@@ -174,6 +168,7 @@ const float RADIANS = PI / 180.f;
 		   ) {
 			*itr = rotate( *itr, about, angle, clockwise );
 		}
+		poly.hull_changed( );
 		return poly;
 	}
 
@@ -184,44 +179,29 @@ const float RADIANS = PI / 180.f;
 
 	template<typename T>
 	point2<T> mirror( const point2<T>& target, const line2<T>& over ) {
+		const point2<T>&  base = over.base_point( );
+		const vector2<T>& dir  = over.base_vector( );
+
 		// translate point & line to origin
-		line2<T> t_over = translate( over, -over.start_pt( ).x,
-		                                   -over.start_pt( ).y );
-		point2<T> t_targ = translate( target, -over.start_pt( ).x,
-		                                      -over.start_pt( ).y );
-
-		// get translation matrix
-		float length = segment2<T>{ point2<T>{ 0, 0 }, t_over.end_pt( ) }.length( );
-		length *= length;
-		float matrix[4] = {
-			static_cast<float>( t_over.end_pt( ).x*t_over.end_pt( ).x -
-			                    t_over.end_pt( ).y*t_over.end_pt( ).y ),
-			static_cast<float>( 2 * t_over.end_pt( ).x * t_over.end_pt( ).y ),
-			static_cast<float>( 2 * t_over.end_pt( ).x * t_over.end_pt( ).y ),
-			static_cast<float>( t_over.end_pt( ).y*t_over.end_pt( ).y -
-			                    t_over.end_pt( ).x*t_over.end_pt( ).x )
+		point2<T> t_targ = translate( target, -base.x( ), -base.y( ) );
+
+		// get reflection matrix
+		T length = dir.length_sq( );
+		T matrix[4] = {
+			dir.x( )*dir.x( ) - dir.y( )*dir.y( ),
+			2 * dir.x( ) * dir.y( ),
+			2 * dir.x( ) * dir.y( ),
+			dir.y( )*dir.y( ) - dir.x( )*dir.x( )
 		};
-		if( not_equal( length, 0.f ) ) {
+		if( not_equal( length, T(0) ) ) {
 			for( int i = 0; i < 4; ++i ) {
 				matrix[i] /= length;
 			}
 		}
 
-		// calculate new point
-		point2f tmp = { ( matrix[0]*static_cast<float>(t_targ.x) +
-		                  matrix[1]*static_cast<float>(t_targ.y) ),
-		                ( matrix[2]*static_cast<float>(t_targ.x) +
-		                  matrix[3]*static_cast<float>(t_targ.y) ) };
-		// reduce rounding errors if T is an integer type
-		if( std::numeric_limits<T>::is_integer ) {
-			tmp.x += 0.5f;
-			tmp.y += 0.5f;
-		}
-
-		// translate back
-		return translate( point2<T>{ static_cast<T>(tmp.x),
-		                             static_cast<T>(tmp.y) },
-		                  over.start_pt( ).x, over.start_pt( ).y );
+		// reflect and translate back
+		return point2<T>{ matrix[0]*t_targ.x( ) + matrix[1]*t_targ.y( ) + base.x( ),
+		                  matrix[2]*t_targ.x( ) + matrix[3]*t_targ.y( ) + base.y( ) };
 	}
 
 	template<typename T>
@@ -242,6 +222,7 @@ const float RADIANS = PI / 180.f;
 		for( auto itr = poly.m_hull.begin( ); itr != poly.m_hull.end( ); ++itr ) {
 			*itr = mirror( *itr, over );
 		}
+		poly.hull_changed( );
 		return poly;
 	}
 
@@ -272,13 +253,27 @@ const float RADIANS = PI / 180.f;
 
 	// point with *
 
+	// points have no null value of their own, a point with
+	//   every coordinate at infinity (or max) stands in for one
+	template<typename T> inline
+	point2<T> null_point( const point2<T>& ) {
+		typedef std::numeric_limits<T> limit_t;
+		const T invalid = limit_t::has_infinity ? limit_t::infinity( ) : limit_t::max( );
+		return point2<T>{ invalid, invalid };
+	}
+
+	template<typename T> inline
+	bool is_null( const point2<T>& pt ) {
+		return pt.x( ) == null_point( pt ).x( ) && pt.y( ) == null_point( pt ).y( );
+	}
+
 	template<typename T>
 	point2<T> overlap( const point2<T>& pt1, const point2<T>& pt2 ) {
 		if( pt1 == pt2 ) {
 			return pt1;
 		}
 		else {
-			return point2<T>::null( );
+			return null_point( pt1 );
 		}
 	}
 
@@ -307,157 +302,96 @@ const float RADIANS = PI / 180.f;
 
 	template<typename T>
 	point2<T> overlap( const point2<T>& pt, const rect2<T>& rect ) {
-		// check if either is null
-		if( pt == point2<T>::null( ) || rect == rect2<T>::null( ) ) {
-			return point2<T>::null( );
+		// check if null
+		if( rect == rect2<T>::null( ) ) {
+			return null_point( pt );
 		}
 		// general case
-		else if( greater_equal( pt.x, rect.l ) &&
-		         less_equal( pt.x, rect.r ) &&
-		         greater_equal( pt.y, rect.t ) &&
-		         less_equal( pt.y, rect.b ) ) {
+		else if( greater_than_eq( pt.x( ), rect.l ) &&
+		         less_than_eq( pt.x( ), rect.r ) &&
+		         greater_than_eq( pt.y( ), rect.t ) &&
+		         less_than_eq( pt.y( ), rect.b ) ) {
 			return pt;
 		}
 		else {
-			return point2<T>::null( );
+			return null_point( pt );
 		}
 	}
 
 	template<typename T>
 	point2<T> overlap( const point2<T>& pt, const polygon2<T>& poly ) {
-		// check if either is null
-		if( pt == point2<T>::null( ) || poly == polygon2<T>::null( ) ) {
-			return point2<T>::null( );
-		}
-		// check bounding box first
-		if( overlap( pt, poly.m_bounding_box ) == point2<T>::null( ) ) {
-			return point2<T>::null( );
+		if( poly.contains( pt ) ) {
+			return pt;
 		}
+		return null_point( pt );
+	}
 
-		// check actual polygon
-		//   the point should be on the same side of every line making
-		//   up the polygon if it is inside
-		float dir = poly.direction( poly.m_hull[0], poly.m_hull[1], pt );
-		bool side = dir > std::numeric_limits<T>::epsilon( );
-		for( unsigned int i = 1; i < poly.m_hull.size( ); ++i ) {
-			// check last element w/ first
-			if( i == poly.m_hull.size( ) - 1 ) {
-				dir = poly.direction( poly.m_hull[i], poly.m_hull[0], pt );
-			}
-			else {
-				dir = poly.direction( poly.m_hull[i], poly.m_hull[i+1], pt );
-			}
-			// different side, can't be inside
-			if( side != (dir > std::numeric_limits<T>::epsilon( )) ) {
-				return point2<T>::null( );
-			}
+
+	// polygon with *
+
+	// friend function
+	//   the vertices are written into result's own storage, so reusing one
+	//   result across calls does not allocate once it has grown large enough
+	template<typename T>
+	polygon2<T>& overlap( const polygon2<T>& poly1, const polygon2<T>& poly2,
+	                      polygon2<T>& result ) {
+		if( &result == &poly1 || &result == &poly2 ) {
+			return result = overlap( poly1, poly2 );
+		}
+		poly1.sync_hull( );
+		poly2.sync_hull( );
+
+		const rect2<T>& box1 = poly1.m_bounding_box;
+		const rect2<T>& box2 = poly2.m_bounding_box;
+		result.m_hull.clear( );
+		if( box1.r >= box2.l && box2.r >= box1.l && box1.b >= box2.t && box2.b >= box1.t ) {
+			const std::vector<point2<T>>& hull1 = poly1.m_hull;
+			const std::vector<point2<T>>& hull2 = poly2.m_hull;
+			result.m_hull.resize( hull1.size( ) + hull2.size( ) );
+			point2<T>* last = convex_intersection( hull1.begin( ), hull1.end( ),
+			                                       hull2.begin( ), hull2.end( ),
+			                                       result.m_hull.data( ) );
+			result.m_hull.resize( last - result.m_hull.data( ) );
 		}
+		result.hull_changed( );
+		return result;
+	}
 
-		return pt;
+	template<typename T>
+	polygon2<T> overlap( const polygon2<T>& poly1, const polygon2<T>& poly2 ) {
+		polygon2<T> result;
+		overlap( poly1, poly2, result );
+		return result;
 	}
 
 
 	// line with *
-/*
-	template<typename T>
-	point2<T> overlap( const line2<T>& line, const point2<T>& pt ) {
-		return overlap( pt, line );
-	}
 
+	// null_point( ) when the lines are parallel, see intersect( )
 	template<typename T>
 	point2<T> overlap( const line2<T>& ln1, const line2<T>& ln2 ) {
-		// check if null
-		if( ln1 == line2<T>::null( ) || ln2 == line2<T>::null( ) ) {
-			return point2<T>::null( );
+		point2<T> pt;
+		if( !intersect( ln1, ln2, pt ) ) {
+			return null_point( pt );
 		}
-		// check if parallel
-		else if( std::abs( ln1.slope( ) - ln2.slope( ) )
-		         <= std::numeric_limits<float>::epsilon( ) ) {
-			return point2<T>::null( );
-		}
-		// check if parallel and vertical
-		else if( ln1.intercept( ) == std::numeric_limits<float>::infinity( ) &&
-		         ln1.intercept( ) == std::numeric_limits<float>::infinity( ) ) {
-			return point2<T>::null( );
-		}
-
-		// if ln1 is vertical
-		if( ln1.intercept( ) == std::numeric_limits<float>::infinity( ) ) {
-			float x = (float)ln1.pt1.x;
-			float y = ln2.slope( )*x + ln2.intercept( );
-			// reduce rounding errors if T is an integer type
-			if( std::numeric_limits<T>::is_integer ) {
-				x += 0.5f;
-				y += 0.5f;
-			}
-			return point2<T> { (T)x, (T)y };
-		}
-		// if ln2 is vertical
-		else if( ln2.intercept( ) == std::numeric_limits<float>::infinity( ) ) {
-			float x = (float)ln2.pt1.x;
-			float y = ln1.slope( )*x + ln1.intercept( );
-			// reduce rounding errors if T is an integer type
-			if( std::numeric_limits<T>::is_integer ) {
-				x += 0.5f;
-				y += 0.5f;
-			}
-			return point2<T>{ (T)x, (T)y };
-		}
-
-		// general case
-		float x = (ln1.intercept( )-ln2.intercept( )) / (ln2.slope( )-ln1.slope( ));
-		float y = ln1.slope( )*x + ln1.intercept( );
-		// reduce rounding errors if T is an integer type
-		if( std::numeric_limits<T>::is_integer ) {
-			x += 0.5f;
-			y += 0.5f;
-		}
-		return point2<T>{ (T)x, (T)y };
+		return pt;
 	}
 
-	// TODO: this seems really messy, there should be a better/cleaner algo
+	// the part inside rect, false if there is none, see clip.hpp
 	template<typename T>
-	line2<T> overlap( const line2<T>& line, const rect2<T>& rect ) {
-		// check null
-		if( line == line2<T>::null( ) || rect == rect2<T>::null( ) ) {
-			return line2<T>::null( );
-		}
-
-		// get intersections with each edge
-		point2<T> l = overlap( line, rect.left( ) );
-		point2<T> r = overlap( line, rect.right( ) );
-		point2<T> t = overlap( line, rect.top( ) );
-		point2<T> b = overlap( line, rect.bottom( ) );
-		bool i_l, i_r, i_t, i_b;
-		i_l = i_r = i_t = i_b = false;
-
-		// which edge does it intersect with?
-		if( l.y - rect.t > std::numeric_limits<T>::epsilon( ) &&
-		    rect.b - l.y > std::numeric_limits<T>::epsilon( ) ) {
-			i_l = true;
-		}
-		if( r.y - rect.t > std::numeric_limits<T>::epsilon( ) &&
-		    rect.b - r.y > std::numeric_limits<T>::epsilon( ) ) {
-			i_r = true;
-		}
-		if( t.x - rect.l > std::numeric_limits<T>::epsilon( ) &&
-		    rect.r - t.x > std::numeric_limits<T>::epsilon( ) ) {
-			i_t = true;
-		}
-		if( b.x - rect.l > std::numeric_limits<T>::epsilon( ) &&
-		    rect.r - b.x > std::numeric_limits<T>::epsilon( ) ) {
-			i_b = true;
-		}
+	bool overlap( const line2<T>& line, const rect2<T>& rect, segment2<T>& result ) {
+		return clip_line( line, rect, result );
+	}
 
-		// return proper line
-		if( i_l && i_r ) { return line2<T>{ l, r }; }
-		else if( i_l && i_t ) { return line2<T>{ l, t }; }
-		else if( i_l && i_b ) { return line2<T>{ l, b }; }
-		else if( i_r && i_t ) { return line2<T>{ r, t }; }
-		else if( i_r && i_b ) { return line2<T>{ r, b }; }
-		else if( i_t && i_b ) { return line2<T>{ t, b }; }
+	template<typename T>
+	bool overlap( const segment2<T>& segment, const rect2<T>& rect, segment2<T>& result ) {
+		return clip_segment( segment, rect, result );
+	}
 
-		return line2<T>::null( );
+/*
+	template<typename T>
+	point2<T> overlap( const line2<T>& line, const point2<T>& pt ) {
+		return overlap( pt, line );
 	}
 
 	// TODO: only checks against bounding box right now
@@ -499,6 +433,66 @@ const float RADIANS = PI / 180.f;
 //	template<typename T>
 
 
+/***********************
+ * Minkowski Functions *
+ ***********************/
+/** minkowski_sum ( poly1, poly2 )
+ *    every point of poly1 plus every point of poly2, e.g. an obstacle grown
+ *    by a footprint.  minkowski_difference( poly1, poly2 ) is poly1 plus
+ *    poly2 reflected through the origin.  Both are O(n + m), see convex.hpp,
+ *    and the result is already a hull.
+ */
+
+	// friend function
+	//   the vertices are written into result's own storage, see overlap( )
+	template<typename T>
+	polygon2<T>& minkowski_sum( const polygon2<T>& poly1, const polygon2<T>& poly2,
+	                            polygon2<T>& result ) {
+		if( &result == &poly1 || &result == &poly2 ) {
+			return result = minkowski_sum( poly1, poly2 );
+		}
+		const std::vector<point2<T>>& hull1 = poly1.vertices( );
+		const std::vector<point2<T>>& hull2 = poly2.vertices( );
+		result.m_hull.resize( hull1.size( ) + hull2.size( ) );
+		point2<T>* last = minkowski_sum( hull1.begin( ), hull1.end( ),
+		                                 hull2.begin( ), hull2.end( ), result.m_hull.data( ) );
+		result.m_hull.resize( last - result.m_hull.data( ) );
+		result.hull_changed( );
+		return result;
+	}
+
+	template<typename T>
+	polygon2<T> minkowski_sum( const polygon2<T>& poly1, const polygon2<T>& poly2 ) {
+		polygon2<T> result;
+		minkowski_sum( poly1, poly2, result );
+		return result;
+	}
+
+	// friend function
+	template<typename T>
+	polygon2<T>& minkowski_difference( const polygon2<T>& poly1, const polygon2<T>& poly2,
+	                                   polygon2<T>& result ) {
+		if( &result == &poly1 || &result == &poly2 ) {
+			return result = minkowski_difference( poly1, poly2 );
+		}
+		const std::vector<point2<T>>& hull1 = poly1.vertices( );
+		const std::vector<point2<T>>& hull2 = poly2.vertices( );
+		result.m_hull.resize( hull1.size( ) + hull2.size( ) );
+		point2<T>* last = minkowski_difference( hull1.begin( ), hull1.end( ),
+		                                        hull2.begin( ), hull2.end( ), result.m_hull.data( ) );
+		result.m_hull.resize( last - result.m_hull.data( ) );
+		result.hull_changed( );
+		return result;
+	}
+
+	template<typename T>
+	polygon2<T> minkowski_difference( const polygon2<T>& poly1, const polygon2<T>& poly2 ) {
+		polygon2<T> result;
+		minkowski_difference( poly1, poly2, result );
+		return result;
+	}
+
+
 } // End namespace euclib
 
 #endif // EUBLIB_HELPER_HPP
@@ -81,22 +81,28 @@ namespace euclib {
 // Helper functions for comparisons, because no assumptions
 //   can be made about the exactness of type T
 
+// std::abs is not constexpr
 template<typename T>
-inline bool equal( T lhs, T rhs );
+constexpr T absolute( T value ) {
+	return value < T(0) ? -value : value;
+}
+
+template<typename T>
+constexpr bool equal( T lhs, T rhs );
 
 	template<typename T>
-	inline bool equal( T lhs, T rhs, mpl::inaccurate_tag ) {
-		return std::abs( lhs - rhs ) <= std::numeric_limits<T>::epsilon( ) *
-		                                ( std::abs(lhs) + std::abs(rhs) + 1.0 );
+	constexpr bool equal( T lhs, T rhs, mpl::inaccurate_tag ) {
+		return absolute( lhs - rhs ) <= std::numeric_limits<T>::epsilon( ) *
+		                                ( absolute(lhs) + absolute(rhs) + 1.0 );
 	}
 
 	template<typename T>
-	inline bool equal( T lhs, T rhs, mpl::accurate_tag ) {
+	constexpr bool equal( T lhs, T rhs, mpl::accurate_tag ) {
 		return lhs == rhs;
 	}
 
 	template<typename T>
-	inline bool equal( T lhs, T rhs ) {
+	constexpr bool equal( T lhs, T rhs ) {
 		return equal( lhs, rhs, typename mpl::accuracy_traits<T>::category_t( ) );
 	}
 
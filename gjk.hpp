@@ -0,0 +1,448 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_GJK_HPP
+#define EUBLIB_GJK_HPP
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <cassert>
+
+#include "point.hpp"
+#include "vector.hpp"
+#include "segment.hpp"
+#include "rect.hpp"
+#include "polygon.hpp"
+
+/*
+ * Distance and overlap of convex shapes (Gilbert, Johnson and Keerthi)
+ *
+ *   GJK never looks at a shape directly, only through its support function,
+ *   the point of the shape furthest along a direction.  The distance between
+ *   two shapes is the distance from the origin to their Minkowski difference,
+ *   which is searched with a simplex of at most three support points.
+ *
+ *   Any convex shape can take part by overloading
+ *
+ *     point2<T> support( const Shape& shape, const vector2<T>& dir );
+ *
+ *   and specializing mpl::coordinate_of.  The queries below only take part in
+ *   overload resolution for two shapes that both do, with the same T.
+ *
+ *   A gjk_cache holds the directions of the final simplex.  Passing the same
+ *   cache on the next query starts from those directions again, which for
+ *   shapes that only moved a little is usually one or two iterations from
+ *   the answer.
+ */
+
+namespace euclib {
+
+namespace mpl {
+	// The coordinate type of a shape with a support( ) overload
+	template<typename Shape>
+	struct coordinate_of;
+
+	template<typename T>
+	struct coordinate_of<point<T,2>> { typedef T type; };
+	template<typename T>
+	struct coordinate_of<segment<T,2>> { typedef T type; };
+	template<typename T>
+	struct coordinate_of<rect2<T>> { typedef T type; };
+	template<typename T>
+	struct coordinate_of<polygon2<T>> { typedef T type; };
+
+	// R when both shapes have coordinates T, otherwise no type at all
+	template<typename ShapeA, typename ShapeB, typename T, typename R>
+	using if_shapes_t = typename std::enable_if<
+		std::is_same<typename coordinate_of<ShapeA>::type, T>::value &&
+		std::is_same<typename coordinate_of<ShapeB>::type, T>::value, R>::type;
+}
+
+
+////////////////////////////////////////
+// Support functions
+//   ties between points equally far along dir may return either
+
+template<typename T>
+inline point2<T> support( const point2<T>& pt, const vector2<T>& ) {
+	return pt;
+}
+
+template<typename T>
+inline point2<T> support( const segment2<T>& segment, const vector2<T>& dir ) {
+	const point2<T>&  base = segment.base_point( );
+	const vector2<T>& vec  = segment.base_vector( );
+	if( vec.x( ) * dir.x( ) + vec.y( ) * dir.y( ) > T(0) ) {
+		return point2<T>( base.x( ) + vec.x( ), base.y( ) + vec.y( ) );
+	}
+	return base;
+}
+
+template<typename T>
+inline point2<T> support( const rect2<T>& rect, const vector2<T>& dir ) {
+	return point2<T>( dir.x( ) > T(0) ? rect.r : rect.l,
+	                  dir.y( ) > T(0) ? rect.b : rect.t );
+}
+
+template<typename T>
+point2<T> support( const polygon2<T>& poly, const vector2<T>& dir ) {
+	const std::vector<point2<T>>& hull = poly.vertices( );
+	assert( !hull.empty( ) );
+
+	std::size_t best = 0;
+	T best_dot = hull[0].x( ) * dir.x( ) + hull[0].y( ) * dir.y( );
+	for( std::size_t i = 1; i < hull.size( ); ++i ) {
+		T dot = hull[i].x( ) * dir.x( ) + hull[i].y( ) * dir.y( );
+		if( dot > best_dot ) {
+			best_dot = dot;
+			best = i;
+		}
+	}
+	return hull[best];
+}
+
+
+////////////////////////////////////////
+// Query state and result
+
+template<typename T>
+struct gjk_cache {
+	vector2<T>   dirs[3];  // directions the simplex vertices were found along
+	unsigned int count;
+
+	gjk_cache( ) : count( 0 ) { }
+};
+
+template<typename T>
+struct gjk_result {
+	T            distance;    // zero when the shapes overlap or touch
+	point2<T>    on_a;        // closest points, only meaningful when
+	point2<T>    on_b;        //   the shapes do not overlap
+	bool         overlap;
+	bool         converged;   // false when the iteration limit was hit, overlap
+	unsigned int iterations;  //   is then false and distance only an upper bound
+};
+
+
+namespace detail { namespace gjk {
+
+	template<typename T>
+	inline T cross( T ax, T ay, T bx, T by ) { return ax * by - ay * bx; }
+
+	template<typename T>
+	struct vertex {
+		point2<T>  a, b;  // support points of each shape
+		T          wx, wy; // a - b, a point of the Minkowski difference
+		vector2<T> dir;
+		T          l;     // barycentric weight in the closest point
+	};
+
+	template<typename T, typename ShapeA, typename ShapeB>
+	inline vertex<T> make_vertex( const ShapeA& a, const ShapeB& b, const vector2<T>& dir ) {
+		vertex<T> v;
+		v.a = support( a, dir );
+		v.b = support( b, vector2<T>( -dir.x( ), -dir.y( ) ) );
+		v.wx = v.a.x( ) - v.b.x( );
+		v.wy = v.a.y( ) - v.b.y( );
+		v.dir = dir;
+		v.l = T(1);
+		return v;
+	}
+
+	// Reduces the simplex to the vertices whose hull holds the point
+	//   closest to the origin and sets their weights, from Box2D's b2Simplex
+	template<typename T>
+	struct simplex {
+		vertex<T>    v[3];
+		unsigned int count;
+
+		void solve2( ) {
+			const T e12x = v[1].wx - v[0].wx, e12y = v[1].wy - v[0].wy;
+			const T d12_1 = v[1].wx * e12x + v[1].wy * e12y;
+			const T d12_2 = -( v[0].wx * e12x + v[0].wy * e12y );
+
+			if( d12_2 <= T(0) ) {  // first vertex region
+				v[0].l = T(1);
+				count = 1;
+			}
+			else if( d12_1 <= T(0) ) {  // second vertex region
+				v[0] = v[1];
+				v[0].l = T(1);
+				count = 1;
+			}
+			else {
+				const T inv = T(1) / ( d12_1 + d12_2 );
+				v[0].l = d12_1 * inv;
+				v[1].l = d12_2 * inv;
+				count = 2;
+			}
+		}
+
+		void solve3( ) {
+			const T w1x = v[0].wx, w1y = v[0].wy;
+			const T w2x = v[1].wx, w2y = v[1].wy;
+			const T w3x = v[2].wx, w3y = v[2].wy;
+
+			const T e12x = w2x - w1x, e12y = w2y - w1y;
+			const T d12_1 = w2x * e12x + w2y * e12y;
+			const T d12_2 = -( w1x * e12x + w1y * e12y );
+
+			const T e13x = w3x - w1x, e13y = w3y - w1y;
+			const T d13_1 = w3x * e13x + w3y * e13y;
+			const T d13_2 = -( w1x * e13x + w1y * e13y );
+
+			const T e23x = w3x - w2x, e23y = w3y - w2y;
+			const T d23_1 = w3x * e23x + w3y * e23y;
+			const T d23_2 = -( w2x * e23x + w2y * e23y );
+
+			const T n123 = cross( e12x, e12y, e13x, e13y );
+			const T d123_1 = n123 * cross( w2x, w2y, w3x, w3y );
+			const T d123_2 = n123 * cross( w3x, w3y, w1x, w1y );
+			const T d123_3 = n123 * cross( w1x, w1y, w2x, w2y );
+
+			if( d12_2 <= T(0) && d13_2 <= T(0) ) {
+				v[0].l = T(1);
+				count = 1;
+			}
+			else if( d12_1 > T(0) && d12_2 > T(0) && d123_3 <= T(0) ) {
+				const T inv = T(1) / ( d12_1 + d12_2 );
+				v[0].l = d12_1 * inv;
+				v[1].l = d12_2 * inv;
+				count = 2;
+			}
+			else if( d13_1 > T(0) && d13_2 > T(0) && d123_2 <= T(0) ) {
+				const T inv = T(1) / ( d13_1 + d13_2 );
+				v[0].l = d13_1 * inv;
+				v[2].l = d13_2 * inv;
+				v[1] = v[2];
+				count = 2;
+			}
+			else if( d12_1 <= T(0) && d23_2 <= T(0) ) {
+				v[0] = v[1];
+				v[0].l = T(1);
+				count = 1;
+			}
+			else if( d13_1 <= T(0) && d23_1 <= T(0) ) {
+				v[0] = v[2];
+				v[0].l = T(1);
+				count = 1;
+			}
+			else if( d23_1 > T(0) && d23_2 > T(0) && d123_1 <= T(0) ) {
+				const T inv = T(1) / ( d23_1 + d23_2 );
+				v[1].l = d23_1 * inv;
+				v[2].l = d23_2 * inv;
+				v[0] = v[2];
+				count = 2;
+			}
+			else {  // the origin is inside
+				const T inv = T(1) / ( d123_1 + d123_2 + d123_3 );
+				v[0].l = d123_1 * inv;
+				v[1].l = d123_2 * inv;
+				v[2].l = d123_3 * inv;
+				count = 3;
+			}
+		}
+
+		void solve( ) {
+			if( count == 2 )      { solve2( ); }
+			else if( count == 3 ) { solve3( ); }
+		}
+
+		// towards the origin from the closest feature
+		vector2<T> search_direction( ) const {
+			if( count == 1 ) { return vector2<T>( -v[0].wx, -v[0].wy ); }
+
+			const T ex = v[1].wx - v[0].wx, ey = v[1].wy - v[0].wy;
+			if( cross( ex, ey, -v[0].wx, -v[0].wy ) > T(0) ) {
+				return vector2<T>( -ey, ex );  // origin left of the edge
+			}
+			return vector2<T>( ey, -ex );
+		}
+
+		void closest( T& x, T& y ) const {
+			x = y = T(0);
+			for( unsigned int i = 0; i < count; ++i ) {
+				x += v[i].l * v[i].wx;
+				y += v[i].l * v[i].wy;
+			}
+		}
+
+		void witness( point2<T>& a, point2<T>& b ) const {
+			T ax = 0, ay = 0, bx = 0, by = 0;
+			for( unsigned int i = 0; i < count; ++i ) {
+				ax += v[i].l * v[i].a.x( );  ay += v[i].l * v[i].a.y( );
+				bx += v[i].l * v[i].b.x( );  by += v[i].l * v[i].b.y( );
+			}
+			a = point2<T>( ax, ay );
+			b = point2<T>( bx, by );
+		}
+	};
+
+	// With separation_only the search stops at the first direction
+	//   that separates the shapes, the distance is then not computed
+	template<typename T, typename ShapeA, typename ShapeB>
+	gjk_result<T> run( const ShapeA& shape_a, const ShapeB& shape_b,
+	                   gjk_cache<T>& cache, bool separation_only ) {
+		const unsigned int max_iterations = 64;
+		const T tolerance = T(100) * std::numeric_limits<T>::epsilon( );
+
+		gjk_result<T> result;
+		result.overlap = false;
+		result.converged = true;
+		result.iterations = 0;
+
+		// restart from the cached directions, dropping any that
+		//   now give the same point or a flat triangle
+		simplex<T> s;
+		s.count = 0;
+		for( unsigned int i = 0; i < cache.count && i < 3; ++i ) {
+			vertex<T> v = make_vertex( shape_a, shape_b, cache.dirs[i] );
+			bool repeated = false;
+			for( unsigned int j = 0; j < s.count; ++j ) {
+				repeated = repeated || ( v.wx == s.v[j].wx && v.wy == s.v[j].wy );
+			}
+			if( !repeated ) { s.v[s.count++] = v; }
+		}
+		if( s.count == 3 &&
+		    cross( s.v[1].wx - s.v[0].wx, s.v[1].wy - s.v[0].wy,
+		           s.v[2].wx - s.v[0].wx, s.v[2].wy - s.v[0].wy ) == T(0) ) {
+			s.count = 1;
+		}
+		if( s.count == 0 ) {
+			s.v[s.count++] = make_vertex( shape_a, shape_b, vector2<T>( T(1), T(0) ) );
+		}
+
+		bool separated = false;
+		for( ;; ) {
+			s.solve( );
+			if( s.count == 3 ) {
+				result.overlap = true;
+				break;
+			}
+			if( result.iterations == max_iterations ) {
+				result.converged = false;
+				break;
+			}
+			++result.iterations;
+
+			// the origin is on the simplex
+			vector2<T> dir = s.search_direction( );
+			if( dir.x( ) == T(0) && dir.y( ) == T(0) ) { break; }
+
+			vertex<T> w = make_vertex( shape_a, shape_b, dir );
+			if( w.wx * dir.x( ) + w.wy * dir.y( ) < T(0) ) {
+				separated = true;
+				if( separation_only ) { break; }
+			}
+
+			// no new support point, the simplex is as close as it gets
+			bool repeated = false;
+			for( unsigned int i = 0; i < s.count; ++i ) {
+				repeated = repeated || ( w.wx == s.v[i].wx && w.wy == s.v[i].wy );
+			}
+			if( repeated ) { break; }
+
+			// or too little progress along the direction to the origin
+			T vx, vy;
+			s.closest( vx, vy );
+			const T vv = vx * vx + vy * vy;
+			if( vv - ( vx * w.wx + vy * w.wy ) <= tolerance * vv ) { break; }
+
+			s.v[s.count++] = w;
+		}
+
+		cache.count = s.count;
+		for( unsigned int i = 0; i < s.count; ++i ) { cache.dirs[i] = s.v[i].dir; }
+
+		if( separation_only ) {
+			result.overlap = !separated && result.converged;
+			result.distance = T(0);
+			return result;
+		}
+
+		s.witness( result.on_a, result.on_b );
+		if( result.overlap ) {
+			result.distance = T(0);
+			return result;
+		}
+		using std::sqrt;
+		const T dx = result.on_a.x( ) - result.on_b.x( );
+		const T dy = result.on_a.y( ) - result.on_b.y( );
+		result.distance = sqrt( dx * dx + dy * dy );
+		result.overlap = !separated && result.converged && result.distance == T(0);
+		return result;
+	}
+
+} } // End namespace detail::gjk
+
+
+////////////////////////////////////////
+// Queries
+
+template<typename ShapeA, typename ShapeB,
+         typename T = typename mpl::coordinate_of<ShapeA>::type>
+mpl::if_shapes_t<ShapeA,ShapeB,T,gjk_result<T>>
+gjk( const ShapeA& a, const ShapeB& b, gjk_cache<T>& cache ) {
+	return detail::gjk::run( a, b, cache, false );
+}
+
+template<typename ShapeA, typename ShapeB,
+         typename T = typename mpl::coordinate_of<ShapeA>::type>
+mpl::if_shapes_t<ShapeA,ShapeB,T,gjk_result<T>>
+gjk( const ShapeA& a, const ShapeB& b ) {
+	gjk_cache<T> cache;
+	return detail::gjk::run( a, b, cache, false );
+}
+
+// Zero when the shapes overlap or touch
+template<typename ShapeA, typename ShapeB,
+         typename T = typename mpl::coordinate_of<ShapeA>::type>
+mpl::if_shapes_t<ShapeA,ShapeB,T,T>
+distance( const ShapeA& a, const ShapeB& b, gjk_cache<T>& cache ) {
+	return gjk( a, b, cache ).distance;
+}
+
+template<typename ShapeA, typename ShapeB,
+         typename T = typename mpl::coordinate_of<ShapeA>::type>
+mpl::if_shapes_t<ShapeA,ShapeB,T,T>
+distance( const ShapeA& a, const ShapeB& b ) {
+	return gjk( a, b ).distance;
+}
+
+// Stops as soon as a separating direction is found, which is usually
+//   sooner than the distance is known; also false when the search did
+//   not converge, gjk( ) tells the two apart
+template<typename ShapeA, typename ShapeB,
+         typename T = typename mpl::coordinate_of<ShapeA>::type>
+mpl::if_shapes_t<ShapeA,ShapeB,T,bool>
+intersects( const ShapeA& a, const ShapeB& b, gjk_cache<T>& cache ) {
+	return detail::gjk::run( a, b, cache, true ).overlap;
+}
+
+template<typename ShapeA, typename ShapeB,
+         typename T = typename mpl::coordinate_of<ShapeA>::type>
+mpl::if_shapes_t<ShapeA,ShapeB,T,bool>
+intersects( const ShapeA& a, const ShapeB& b ) {
+	gjk_cache<T> cache;
+	return detail::gjk::run( a, b, cache, true ).overlap;
+}
+
+}  // End namespace euclib
+
+#endif // EUBLIB_GJK_HPP
@@ -0,0 +1,547 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_HULL_HPP
+#define EUBLIB_HULL_HPP
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <map>
+
+#include "simd.hpp"
+#include "point.hpp"
+#include "predicates.hpp"
+
+/*
+ * Convex hull of a set of 2d points
+ *
+ *   Andrew's monotone chain with the orient2d predicate, so no angles are
+ *   computed and the result is exact.  The points are first split by the
+ *   line through the leftmost and rightmost points; points on that line can
+ *   never be hull vertices and are dropped, the rest are sorted on their own
+ *   side only.  The chain is then built in place over
+ *
+ *     leftmost, below ascending, rightmost, above descending
+ *
+ *   which needs no memory beyond the input.  The hull is counterclockwise,
+ *   starts at the leftmost (then lowest) point and has no duplicate or
+ *   collinear vertices.
+ *
+ *   Large inputs first go through the Akl-Toussaint prefilter, which drops
+ *   the points strictly inside the octagon spanned by the points extreme in
+ *   x, y, x+y and x-y.  On uniformly spread points that is nearly all of them.
+ *
+ *   With execution::par the range is cut into one block per thread, each
+ *   block is reduced to its own hull concurrently, and the hull of those
+ *   partial hulls (which are small) is the hull of the whole range.  The
+ *   blocks run on a pool of one thread per hardware thread, less the caller,
+ *   started on first use and kept until the program exits.  Only ranges
+ *   large enough to pay for handing them out are split.
+ *
+ *   incremental_hull keeps a hull that points are inserted into one at a
+ *   time, see below.
+ */
+
+namespace euclib {
+
+////////////////////////////////////////
+// Execution policies, in the spirit of std::execution
+
+namespace execution {
+
+	struct sequenced_policy { };
+
+	struct parallel_policy {
+		unsigned int threads;  // 0 uses every hardware thread, more are capped to that
+
+		constexpr parallel_policy( unsigned int count = 0 ) : threads( count ) { }
+		constexpr parallel_policy operator ( ) ( unsigned int count ) const { return parallel_policy( count ); }
+	};
+
+	constexpr sequenced_policy seq { };
+	constexpr parallel_policy  par { };
+
+} // End namespace execution
+
+
+////////////////////////////////////////
+// Worker threads for the parallel policy
+
+namespace detail {
+
+	// run( count, f ) calls f( i ) for every i < count, spread over the
+	//   workers and the calling thread, and returns once all have returned;
+	//   the first exception thrown by f is rethrown to the caller
+	class thread_pool {
+	// Variables
+		std::vector<std::thread>                 m_workers;
+		std::mutex                               m_lock;     // guards everything below
+		std::condition_variable                  m_wake;     // a batch was posted or the pool stops
+		std::condition_variable                  m_idle;     // the last call of a batch returned
+		const std::function<void(std::size_t)>*  m_task;
+		std::size_t                              m_count;
+		std::size_t                              m_next;     // next index to hand out
+		std::size_t                              m_running;  // calls that have not returned
+		std::exception_ptr                       m_error;
+		bool                                     m_stop;
+		std::mutex                               m_batch;    // one batch at a time
+
+	// Constructors
+	public:
+		// a worker that fails to start leaves the pool smaller
+		explicit thread_pool( std::size_t workers ) :
+			m_task( nullptr ), m_count( 0 ), m_next( 0 ), m_running( 0 ), m_stop( false ) {
+			try {
+				m_workers.reserve( workers );
+				for( std::size_t i = 0; i < workers; ++i ) {
+					m_workers.emplace_back( [this]( ) { serve( ); } );
+				}
+			}
+			catch( ... ) { }
+		}
+
+		thread_pool( const thread_pool& ) = delete;
+		thread_pool& operator = ( const thread_pool& ) = delete;
+
+		~thread_pool( ) {
+			{
+				std::lock_guard<std::mutex> lock( m_lock );
+				m_stop = true;
+			}
+			m_wake.notify_all( );
+			for( auto& worker : m_workers ) { worker.join( ); }
+		}
+
+	// Methods
+		static thread_pool& instance( ) {
+			static thread_pool pool( std::max( std::thread::hardware_concurrency( ), 1u ) - 1 );
+			return pool;
+		}
+
+		std::size_t size( ) const { return m_workers.size( ); }
+
+		// a call made while another batch runs, from a task or another
+		//   thread, runs on the calling thread alone
+		template<typename F>
+		void run( std::size_t count, F f ) {
+			const std::function<void(std::size_t)> task( f );
+			std::unique_lock<std::mutex> batch( m_batch, std::try_to_lock );
+			if( !batch.owns_lock( ) || m_workers.empty( ) ) {
+				for( std::size_t i = 0; i < count; ++i ) { task( i ); }
+				return;
+			}
+
+			std::unique_lock<std::mutex> lock( m_lock );
+			m_task = &task;
+			m_count = count;
+			m_next = 0;
+			m_error = nullptr;
+			m_wake.notify_all( );
+			work( lock );
+			m_idle.wait( lock, [this]( ) { return m_running == 0; } );
+			m_task = nullptr;
+			if( m_error ) { std::rethrow_exception( m_error ); }
+		}
+
+	private:
+		// takes indices until the batch has none left, m_lock is held
+		//   on entry and exit but not while the task runs
+		void work( std::unique_lock<std::mutex>& lock ) {
+			while( m_task != nullptr && m_next < m_count ) {
+				const std::size_t i = m_next++;
+				++m_running;
+				lock.unlock( );
+				std::exception_ptr error;
+				try { ( *m_task )( i ); }
+				catch( ... ) { error = std::current_exception( ); }
+				lock.lock( );
+				if( error && !m_error ) { m_error = error; }
+				if( --m_running == 0 && m_next >= m_count ) { m_idle.notify_all( ); }
+			}
+		}
+
+		void serve( ) {
+			std::unique_lock<std::mutex> lock( m_lock );
+			for( ;; ) {
+				m_wake.wait( lock, [this]( ) {
+					return m_stop || ( m_task != nullptr && m_next < m_count );
+				} );
+				if( m_stop ) { return; }
+				work( lock );
+			}
+		}
+	}; // End class thread_pool
+
+} // End namespace detail
+
+
+namespace detail {
+
+	// function objects rather than functions so that the sorts inline them
+	struct lexicographic_less {
+		template<typename T>
+		bool operator () ( const point2<T>& lhs, const point2<T>& rhs ) const {
+			return lhs.x( ) < rhs.x( ) || ( lhs.x( ) == rhs.x( ) && lhs.y( ) < rhs.y( ) );
+		}
+	};
+
+	struct lexicographic_greater {
+		template<typename T>
+		bool operator () ( const point2<T>& lhs, const point2<T>& rhs ) const {
+			return lexicographic_less( )( rhs, lhs );
+		}
+	};
+
+	template<typename T>
+	inline bool same_point( const point2<T>& lhs, const point2<T>& rhs ) {
+		return lhs.x( ) == rhs.x( ) && lhs.y( ) == rhs.y( );
+	}
+
+
+	// The octagon with its edges laid out for the packets,
+	//   edge k runs from ( ax[k], ay[k] ) to ( bx[k], by[k] )
+	template<typename T>
+	struct octagon {
+		typedef simd::packet<T>          packet_t;
+		typedef typename packet_t::type  type;
+		enum { edges = 8 };
+
+		alignas( 16 ) T ax[edges], ay[edges], bx[edges], by[edges];
+		bool valid;  // false when fewer than 3 distinct extremes
+
+		template<typename RandomIt>
+		octagon( RandomIt first, RandomIt last ) : valid( false ) {
+			// counterclockwise: -y, x-y, x, x+y, y, y-x, -x, -x-y
+			point2<T> extreme[edges];
+			std::fill( extreme, extreme + edges, *first );
+			for( RandomIt itr = first; itr != last; ++itr ) {
+				const T x = itr->x( ), y = itr->y( );
+				if( y < extreme[0].y( ) ) { extreme[0] = *itr; }
+				if( x - y > extreme[1].x( ) - extreme[1].y( ) ) { extreme[1] = *itr; }
+				if( x > extreme[2].x( ) ) { extreme[2] = *itr; }
+				if( x + y > extreme[3].x( ) + extreme[3].y( ) ) { extreme[3] = *itr; }
+				if( y > extreme[4].y( ) ) { extreme[4] = *itr; }
+				if( y - x > extreme[5].y( ) - extreme[5].x( ) ) { extreme[5] = *itr; }
+				if( x < extreme[6].x( ) ) { extreme[6] = *itr; }
+				if( x + y < extreme[7].x( ) + extreme[7].y( ) ) { extreme[7] = *itr; }
+			}
+
+			// a repeated vertex would give an empty edge that nothing is inside
+			std::size_t count = 0;
+			for( std::size_t k = 0; k < edges; ++k ) {
+				if( count == 0 || !same_point( extreme[k], extreme[count-1] ) ) {
+					extreme[count++] = extreme[k];
+				}
+			}
+			while( count > 1 && same_point( extreme[count-1], extreme[0] ) ) { --count; }
+			if( count < 3 ) { return; }
+
+			// unused slots repeat the first edge
+			for( std::size_t k = 0; k < edges; ++k ) {
+				const std::size_t from = k < count ? k : 0;
+				const std::size_t to = from + 1 == count ? 0 : from + 1;
+				ax[k] = extreme[from].x( ); ay[k] = extreme[from].y( );
+				bx[k] = extreme[to].x( );   by[k] = extreme[to].y( );
+			}
+			valid = true;
+		}
+
+		// the orient2d filter on every edge, a point is only reported
+		//   inside when each filter is certain of its sign; the eight edges
+		//   fill whole packets, so a point at a time does the same work as a
+		//   packet of points per edge, without gathering the points into
+		//   columns, and stops at the first packet of edges it fails
+		bool strictly_inside( const point2<T>& pt ) const {
+			const type px = packet_t::set1( pt.x( ) );
+			const type py = packet_t::set1( pt.y( ) );
+			const type bound = packet_t::set1( predicates::constants<T>::orient2d_bound );
+
+			for( std::size_t k = 0; k < edges; k += packet_t::size ) {
+				type l = packet_t::mul( packet_t::sub( packet_t::load( ax + k ), px ),
+				                        packet_t::sub( packet_t::load( by + k ), py ) );
+				type r = packet_t::mul( packet_t::sub( packet_t::load( ay + k ), py ),
+				                        packet_t::sub( packet_t::load( bx + k ), px ) );
+				type err = packet_t::mul( bound, packet_t::add( packet_t::abs( l ), packet_t::abs( r ) ) );
+				if( !packet_t::all_greater( packet_t::sub( l, r ), err ) ) { return false; }
+			}
+			return true;
+		}
+	};
+
+} // End namespace detail
+
+
+// Akl-Toussaint prefilter
+//   moves every point that may be on the hull to the front of [first, last)
+//   and returns the end of them, the hull of that part is the hull of all
+template<typename RandomIt>
+RandomIt akl_toussaint( RandomIt first, RandomIt last ) {
+	typedef typename std::iterator_traits<RandomIt>::value_type point_t;
+	typedef typename point_t::value_t                           T;
+
+	if( first == last ) { return last; }
+
+	const detail::octagon<T> octagon( first, last );
+	if( !octagon.valid ) { return last; }
+	return std::partition( first, last, [&octagon]( const point_t& pt ) {
+		return !octagon.strictly_inside( pt );
+	} );
+}
+
+
+// Rearranges [first, last) so that it begins with the convex hull
+//   and returns the end of the hull, the rest of the range is unspecified
+template<typename RandomIt>
+RandomIt convex_hull( RandomIt first, RandomIt last ) {
+	typedef typename std::iterator_traits<RandomIt>::value_type point_t;
+	typedef typename point_t::value_t                           T;
+
+	if( first == last ) { return last; }
+
+	// too few points to be worth the extra pass
+	if( last - first > 64 ) { last = akl_toussaint( first, last ); }
+
+	// the extremes go to the front, they are always on the hull
+	auto minmax = std::minmax_element( first, last, detail::lexicographic_less( ) );
+	RandomIt lo = minmax.first, hi = minmax.second;
+	if( detail::same_point( *lo, *hi ) ) { return first + 1; }
+
+	std::iter_swap( first, lo );
+	if( hi == first ) { hi = lo; }  // it was just moved
+	std::iter_swap( first + 1, hi );
+	const point_t left = *first, right = *( first + 1 );
+
+	// below the line, then above it, then the points on it
+	RandomIt below_end = std::partition( first + 2, last, [&]( const point_t& pt ) {
+		return orient2d( left, right, pt ) < T(0);
+	} );
+	RandomIt above_end = std::partition( below_end, last, [&]( const point_t& pt ) {
+		return orient2d( left, right, pt ) > T(0);
+	} );
+
+	// lay out the boundary walk, left at the front and right between the sides
+	std::rotate( first + 1, first + 2, below_end );
+	RandomIt right_pos = below_end - 1;
+	std::sort( first + 1, right_pos, detail::lexicographic_less( ) );
+	std::sort( below_end, above_end, detail::lexicographic_greater( ) );
+
+	// monotone chain, the stack is written over points already read
+	RandomIt top = first + 1;  // one past the top of the stack
+	RandomIt floor = first;    // never popped, nor anything below it
+	auto push = [&]( const point_t& pt ) {
+		while( top - floor >= 2 && orient2d( *( top - 2 ), *( top - 1 ), pt ) <= T(0) ) {
+			--top;
+		}
+		*top++ = pt;
+	};
+
+	for( RandomIt itr = first + 1; itr != right_pos; ++itr ) { push( *itr ); }
+	push( right );
+	floor = top - 1;
+	for( RandomIt itr = below_end; itr != above_end; ++itr ) { push( *itr ); }
+
+	// close the loop back to the leftmost point without keeping it twice
+	while( top - floor >= 2 && orient2d( *( top - 2 ), *( top - 1 ), left ) <= T(0) ) {
+		--top;
+	}
+	return top;
+}
+
+template<typename RandomIt>
+inline RandomIt convex_hull( execution::sequenced_policy, RandomIt first, RandomIt last ) {
+	return convex_hull( first, last );
+}
+
+template<typename RandomIt>
+RandomIt convex_hull( execution::parallel_policy policy, RandomIt first, RandomIt last ) {
+	// below this many points per thread the threads cost more than they save
+	const std::size_t min_block = 1 << 16;
+
+	// never more threads than the pool and the caller
+	detail::thread_pool& pool = detail::thread_pool::instance( );
+	const std::size_t size = last - first;
+	std::size_t threads = pool.size( ) + 1;
+	if( policy.threads != 0 ) { threads = std::min<std::size_t>( threads, policy.threads ); }
+	threads = std::min( threads, size / min_block );
+	if( threads < 2 ) { return convex_hull( first, last ); }
+
+	// block i is [starts[i], starts[i+1]) and its hull ends at ends[i]
+	std::vector<RandomIt> starts( threads + 1 ), ends( threads );
+	for( std::size_t i = 0; i <= threads; ++i ) {
+		starts[i] = first + size * i / threads;
+	}
+
+	pool.run( threads, [&starts,&ends]( std::size_t i ) {
+		ends[i] = convex_hull( starts[i], starts[i+1] );
+	} );
+
+	// gather the partial hulls at the front, each moves towards the
+	//   front of the range, so moving forwards never overwrites input
+	RandomIt gathered = ends[0];
+	for( std::size_t i = 1; i < threads; ++i ) {
+		gathered = std::move( starts[i], ends[i], gathered );
+	}
+	return convex_hull( first, gathered );
+}
+
+// Convex hull of points, the input is left untouched
+template<typename T, typename Policy = execution::sequenced_policy>
+std::vector<point2<T>> convex_hull( const std::vector<point2<T>>& points, Policy policy = Policy( ) ) {
+	std::vector<point2<T>> hull( points );
+	hull.erase( convex_hull( policy, hull.begin( ), hull.end( ) ), hull.end( ) );
+	return hull;
+}
+
+
+
+////////////////////////////////////////
+// Hull built one point at a time
+//   the lower and upper chains are kept in balanced trees keyed on x,
+//   the upper one mirrored in y so that both are handled as lower chains.
+//   A point inside the hull is rejected in O(log n); otherwise it is
+//   spliced in and the vertices it hides are erased, O(log n) amortized
+//   since each vertex is erased at most once.
+
+template<typename T>
+class incremental_hull {
+// Typedefs
+public:
+
+	typedef T                    value_t;
+	typedef std::size_t          size_t;
+
+private:
+
+	typedef std::map<T,T>        chain_t;  // x -> y of each vertex
+
+
+// Variables
+private:
+
+	chain_t m_lower;
+	chain_t m_upper;  // y is negated
+
+
+// Methods
+public:
+
+	bool   empty( ) const { return m_lower.empty( ); }
+	void   clear( )       { m_lower.clear( ); m_upper.clear( ); }
+
+	// number of hull vertices
+	size_t size( ) const {
+		if( m_lower.empty( ) ) { return 0; }
+		return m_lower.size( ) + m_upper.size( ) - shared_ends( );
+	}
+
+	// true if the hull grew
+	bool insert( const point2<T>& pt ) {
+		bool lower = insert( m_lower, pt.x( ), pt.y( ) );
+		bool upper = insert( m_upper, pt.x( ), -pt.y( ) );
+		return lower || upper;
+	}
+
+	// inside or on the boundary
+	bool contains( const point2<T>& pt ) const {
+		return !below( m_lower, pt.x( ), pt.y( ) ) && !below( m_upper, pt.x( ), -pt.y( ) );
+	}
+
+	// writes the hull counterclockwise from the leftmost (then lowest) point
+	template<typename OutputIt>
+	OutputIt copy( OutputIt out ) const {
+		if( m_lower.empty( ) ) { return out; }
+
+		for( auto itr = m_lower.begin( ); itr != m_lower.end( ); ++itr ) {
+			*out++ = point2<T>( itr->first, itr->second );
+		}
+
+		// the chains meet where an end has a single point
+		auto first = m_upper.rbegin( );
+		auto last = m_upper.rend( );
+		if( same_end( m_lower.rbegin( ), m_upper.rbegin( ) ) ) { ++first; }
+		if( same_end( m_lower.begin( ), m_upper.begin( ) ) ) { --last; }
+		for( auto itr = first; itr != last && itr != m_upper.rend( ); ++itr ) {
+			*out++ = point2<T>( itr->first, -itr->second );
+		}
+		return out;
+	}
+
+private:
+
+	template<typename Iterator>
+	static bool same_end( Iterator lower, Iterator upper ) {
+		return lower->second == -upper->second;
+	}
+
+	size_t shared_ends( ) const {
+		size_t shared = same_end( m_lower.begin( ), m_upper.begin( ) ) ? 1 : 0;
+		if( m_lower.size( ) > 1 || m_upper.size( ) > 1 ) {
+			shared += same_end( m_lower.rbegin( ), m_upper.rbegin( ) ) ? 1 : 0;
+		}
+		return shared;
+	}
+
+	static T orient( typename chain_t::const_iterator a, typename chain_t::const_iterator b, T x, T y ) {
+		return orient2d( a->first, a->second, b->first, b->second, x, y );
+	}
+
+	// strictly below the chain, or outside its x range
+	static bool below( const chain_t& chain, T x, T y ) {
+		auto next = chain.lower_bound( x );
+		if( next == chain.end( ) ) { return true; }
+		if( next->first == x ) { return y < next->second; }
+		if( next == chain.begin( ) ) { return true; }
+		return orient( std::prev( next ), next, x, y ) < T(0);
+	}
+
+	// a chain is convex when every vertex turns left
+	static bool insert( chain_t& chain, T x, T y ) {
+		if( !below( chain, x, y ) ) { return false; }
+
+		auto itr = chain.lower_bound( x );
+		if( itr != chain.end( ) && itr->first == x ) { itr = chain.erase( itr ); }
+		itr = chain.emplace_hint( itr, x, y );
+
+		// vertices to the right that no longer turn left
+		for( auto next = std::next( itr ); next != chain.end( ); ) {
+			auto after = std::next( next );
+			if( after == chain.end( ) || orient( itr, next, after->first, after->second ) > T(0) ) { break; }
+			next = chain.erase( next );
+		}
+		// and to the left
+		while( itr != chain.begin( ) ) {
+			auto prev = std::prev( itr );
+			if( prev == chain.begin( ) ) { break; }
+			auto before = std::prev( prev );
+			if( orient( before, prev, x, y ) > T(0) ) { break; }
+			chain.erase( prev );
+		}
+		return true;
+	}
+
+}; // End class incremental_hull<T>
+
+}  // End namespace euclib
+
+#endif // EUBLIB_HULL_HPP
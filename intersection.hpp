@@ -0,0 +1,693 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_INTERSECTION_HPP
+#define EUBLIB_INTERSECTION_HPP
+
+#include <cstddef>	// for std::size_t
+#include <cstdint>
+#include <vector>
+#include <set>
+#include <queue>
+#include <unordered_set>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <cmath>
+#include <cassert>
+#include <type_traits>
+
+#include "point.hpp"
+#include "vector.hpp"
+#include "line.hpp"
+#include "segment.hpp"
+#include "predicates.hpp"
+#include "hull.hpp"
+#include "convex.hpp"
+#include "simd.hpp"
+
+/*
+ * Intersections between lines and segments
+ *
+ *   segment_intersections( ) finds every pair of segments that meet with
+ *   the Bentley-Ottmann sweep, O((n + k) log n) for n segments and k pairs.
+ *   The sweep runs left to right and, at equal x, bottom to top, so that a
+ *   vertical segment starts at its lower end like any other.
+ *
+ *   Every decision is made with the exact predicates.  Only the points where
+ *   two segments properly cross are rounded, and the sweep never orders the
+ *   segments by a rounded point: the ones through an event are ordered by
+ *   direction, and the rest by which side of them the event is on.  Where
+ *   three or more cross at a point that does not round exactly, the ones
+ *   through it are found by an exact test on the lines, not the rounding.
+ *
+ *   Each pair is reported once, at the point where the two first meet in
+ *   sweep order; for collinear segments sharing a stretch that is the
+ *   start of the stretch.
+ *
+ *   Lines are intersected from their point and direction form, with one
+ *   cross product as the only divisor, so vertical lines need no special
+ *   case; closest_points( ) is the counterpart for lines in space, and
+ *   there is a batch form for one line against many.
+ *
+ *   intersect( ) on a segment_block is for the narrow phase after a broadphase has picked the
+ *   candidates: one segment against a segment_block of up to 64, which keeps
+ *   its segments as columns of base points and directions so the crossing
+ *   parameters are worked out a packet at a time.  It is plain floating
+ *   point, use the sweep or segment_intersection( ) where exactness matters.
+ */
+
+namespace euclib {
+
+namespace detail { namespace sweep {
+
+	// Whether the line through e1, e2 goes through the point where the lines
+	//   through a1, a2 and b1, b2 cross, which need not be representable:
+	//   with that point at a1 + t ( a2 - a1 ), t = o( b, a1 ) / ( o( b, a1 ) - o( b, a2 ) ),
+	//   it is o( b, a1 ) o( e, a2 ) == o( b, a2 ) o( e, a1 )
+	template<typename T>
+	bool concurrent( const point2<T>& a1, const point2<T>& a2,
+	                 const point2<T>& b1, const point2<T>& b2,
+	                 const point2<T>& e1, const point2<T>& e2 ) {
+		using std::abs;
+		typedef predicates::constants<T> constants_t;
+
+		// each orientation rounded, with a bound on how far off it is
+		auto orient = [&]( const point2<T>& p, const point2<T>& q, const point2<T>& r, T& err ) {
+			const T left  = ( p.x( ) - r.x( ) ) * ( q.y( ) - r.y( ) );
+			const T right = ( p.y( ) - r.y( ) ) * ( q.x( ) - r.x( ) );
+			err = T(4) * constants_t::epsilon * ( abs( left ) + abs( right ) );
+			return left - right;
+		};
+		T e_ba1, e_ba2, e_ea1, e_ea2;
+		const T ba1 = orient( b1, b2, a1, e_ba1 ), ba2 = orient( b1, b2, a2, e_ba2 );
+		const T ea1 = orient( e1, e2, a1, e_ea1 ), ea2 = orient( e1, e2, a2, e_ea2 );
+		const T lhs = ba1 * ea2, rhs = ba2 * ea1;
+		const T err = abs( ba1 ) * e_ea2 + abs( ea2 ) * e_ba1 + e_ba1 * e_ea2
+		            + abs( ba2 ) * e_ea1 + abs( ea1 ) * e_ba2 + e_ba2 * e_ea1
+		            + T(2) * constants_t::epsilon * ( abs( lhs ) + abs( rhs ) );
+		if( abs( lhs - rhs ) > T(2) * err ) { return false; }
+
+		auto exact = []( const point2<T>& p, const point2<T>& q, const point2<T>& r ) {
+			auto prx = predicates::difference( p.x( ), r.x( ) ), qry = predicates::difference( q.y( ), r.y( ) );
+			auto pry = predicates::difference( p.y( ), r.y( ) ), qrx = predicates::difference( q.x( ), r.x( ) );
+			return prx * qry - pry * qrx;
+		};
+		return ( exact( b1, b2, a1 ) * exact( e1, e2, a2 ) -
+		         exact( b1, b2, a2 ) * exact( e1, e2, a1 ) ).most_significant( ) == T(0);
+	}
+
+	template<typename T>
+	class bentley_ottmann {
+		typedef std::size_t size_t;
+
+		struct ends_t {
+			point2<T> l, r;   // l before r in sweep order
+		};
+
+		struct endpoint_t {
+			point2<T> pt;
+			size_t    seg;
+			bool      start;
+		};
+
+		struct crossing_t {
+			point2<T> pt;
+			size_t    a, b;
+		};
+
+		struct crossing_later {
+			bool operator () ( const crossing_t& lhs, const crossing_t& rhs ) const {
+				return lexicographic_less( )( rhs.pt, lhs.pt );
+			}
+		};
+
+		// Status, the segments the sweep line is crossing, bottom to top
+		//   a segment is only ever compared when it goes through the event:
+		//   against another through it by direction, against the rest by
+		//   the side of them the event is on
+		struct status_less {
+			typedef void is_transparent;
+			const bentley_ottmann* s;
+
+			bool operator () ( size_t a, size_t b ) const {
+				if( a == b ) { return false; }
+				const bool ta = s->m_through[a] != 0, tb = s->m_through[b] != 0;
+				if( ta && !tb ) {
+					if( b == s->m_above ) { return true; }
+					if( b == s->m_below ) { return false; }
+					const T below = s->side( b, s->m_event );
+					if( below != T(0) ) { return below < T(0); }
+				}
+				else if( tb && !ta ) {
+					if( a == s->m_below ) { return true; }
+					if( a == s->m_above ) { return false; }
+					const T above = s->side( a, s->m_event );
+					if( above != T(0) ) { return above > T(0); }
+				}
+				else if( !ta ) {
+					return s->side( b, s->m_seg[a].l ) < T(0);
+				}
+
+				// both through the event, the one turned further left is above
+				const T turn = turn2d( s->m_seg[a].l, s->m_seg[a].r, s->m_seg[b].l, s->m_seg[b].r );
+				if( turn != T(0) ) { return turn > T(0); }
+				return a < b;
+			}
+
+			// segment strictly below the point
+			bool operator () ( size_t e, const point2<T>& pt ) const { return s->side( e, pt ) > T(0); }
+			bool operator () ( const point2<T>& pt, size_t e ) const { return s->side( e, pt ) < T(0); }
+		};
+
+		typedef std::set<size_t,status_less> status_t;
+
+		std::vector<ends_t>   m_seg;
+		static constexpr size_t none = size_t(-1);
+
+		std::vector<char>     m_through;  // goes through the current event
+		point2<T>             m_event;
+		size_t                m_below;    // the status either side of those
+		size_t                m_above;    //   through the event, if known
+
+		status_t                                  m_status;
+		std::vector<typename status_t::iterator>  m_where;
+		std::vector<char>                         m_active;
+		std::vector<char>                         m_taken;    // scratch for gather( )
+
+		std::priority_queue<crossing_t, std::vector<crossing_t>, crossing_later> m_crossings;
+		std::unordered_set<std::uint64_t>         m_known;    // proper crossings found
+		std::vector<std::uint64_t>                m_queued;   // those due at the event
+
+		// positive if pt is above the segment, or left of it when vertical
+		T side( size_t e, const point2<T>& pt ) const {
+			return orient2d( m_seg[e].l, m_seg[e].r, pt );
+		}
+
+		std::uint64_t key( size_t a, size_t b ) const {
+			if( a > b ) { std::swap( a, b ); }
+			return std::uint64_t( a ) * m_seg.size( ) + b;
+		}
+
+		// always worked out the same way round, so a pair has one point
+		convex::crossing meet( size_t a, size_t b, point2<T>& pt ) const {
+			if( a > b ) { std::swap( a, b ); }
+			point2<T> other;
+			return convex::segment_intersection( m_seg[a].l, m_seg[a].r, m_seg[b].l, m_seg[b].r, pt, other );
+		}
+
+		// Neighbours in the status that cross ahead are queued
+		//   touching ends and overlaps are found at the endpoint events
+		void check( size_t a, size_t b ) {
+			if( a > b ) { std::swap( a, b ); }
+			point2<T> pt;
+			if( meet( a, b, pt ) != convex::crossing::proper ) { return; }
+			if( !m_known.insert( key( a, b ) ).second ) { return; }
+			m_crossings.push( crossing_t{ pt, a, b } );
+		}
+
+	public:
+
+		template<typename InputIt>
+		bentley_ottmann( InputIt first, InputIt last ) :
+			m_below( none ),
+			m_above( none ),
+			m_status( status_less{ this } ) {
+			for( ; first != last; ++first ) {
+				point2<T> a = first->base_point( );
+				point2<T> b = a + first->base_vector( );
+				if( lexicographic_less( )( b, a ) ) { std::swap( a, b ); }
+				m_seg.push_back( ends_t{ a, b } );
+			}
+			m_through.assign( m_seg.size( ), 0 );
+			m_where.resize( m_seg.size( ) );
+			m_active.assign( m_seg.size( ), 0 );
+			m_taken.assign( m_seg.size( ), 0 );
+		}
+
+		template<typename Callback>
+		void run( Callback& callback ) {
+			const size_t n = m_seg.size( );
+			std::vector<endpoint_t> endpoints;
+			endpoints.reserve( 2 * n );
+			for( size_t i = 0; i < n; ++i ) {
+				endpoints.push_back( endpoint_t{ m_seg[i].l, i, true } );
+				endpoints.push_back( endpoint_t{ m_seg[i].r, i, false } );
+			}
+			std::sort( endpoints.begin( ), endpoints.end( ),
+				[]( const endpoint_t& lhs, const endpoint_t& rhs ) {
+					return lexicographic_less( )( lhs.pt, rhs.pt );
+				} );
+
+			std::vector<size_t> starting, meeting, inserted;
+			size_t next = 0;
+			while( next < endpoints.size( ) || !m_crossings.empty( ) ) {
+				// the next event, with everything at that point
+				if( m_crossings.empty( ) ||
+				    ( next < endpoints.size( ) && !lexicographic_less( )( m_crossings.top( ).pt, endpoints[next].pt ) ) ) {
+					m_event = endpoints[next].pt;
+				}
+				else {
+					m_event = m_crossings.top( ).pt;
+				}
+
+				starting.clear( );
+				meeting.clear( );
+				for( ; next < endpoints.size( ) && same_point( endpoints[next].pt, m_event ); ++next ) {
+					( endpoints[next].start ? starting : meeting ).push_back( endpoints[next].seg );
+				}
+
+				// the active segments through the event are together in the status,
+				//   the crossings queued here may miss it by the rounding
+				auto itr = m_status.lower_bound( m_event );
+				for( ; itr != m_status.end( ) && side( *itr, m_event ) == T(0); ++itr ) {
+					meeting.push_back( *itr );
+				}
+				m_queued.clear( );
+				for( ; !m_crossings.empty( ) && same_point( m_crossings.top( ).pt, m_event ); m_crossings.pop( ) ) {
+					meeting.push_back( m_crossings.top( ).a );
+					meeting.push_back( m_crossings.top( ).b );
+					m_queued.push_back( key( m_crossings.top( ).a, m_crossings.top( ).b ) );
+				}
+				std::sort( m_queued.begin( ), m_queued.end( ) );
+				meeting.insert( meeting.end( ), starting.begin( ), starting.end( ) );
+				std::sort( meeting.begin( ), meeting.end( ) );
+				meeting.erase( std::unique( meeting.begin( ), meeting.end( ) ), meeting.end( ) );
+				if( !m_queued.empty( ) ) {
+					gather( meeting );
+					std::sort( meeting.begin( ), meeting.end( ) );
+				}
+
+				report( meeting, callback );
+
+				// Where the segments at the event sit in the status; when they
+				//   are together there they are put back in the same place,
+				//   whatever the rounded point says about their neighbours
+				size_t active = 0;
+				for( size_t s : meeting ) {
+					m_taken[s] = 1;
+					if( m_active[s] ) { ++active; }
+				}
+				auto above = m_status.end( );
+				bool together = true;
+				if( active == 0 ) {
+					above = m_status.lower_bound( m_event );
+				}
+				else {
+					auto lowest = m_status.end( ), highest = m_status.end( );
+					size_t found = 0;
+					for( size_t s : meeting ) {
+						if( !m_active[s] ) { continue; }
+						lowest = highest = m_where[s];
+						found = 1;
+						while( lowest != m_status.begin( ) && m_taken[*std::prev( lowest )] ) { --lowest; ++found; }
+						while( std::next( highest ) != m_status.end( ) && m_taken[*std::next( highest )] ) { ++highest; ++found; }
+						break;
+					}
+					together = ( found == active );
+					above = std::next( highest );
+				}
+				m_below = m_above = none;
+				if( together ) {
+					if( above != m_status.end( ) ) { m_above = *above; }
+					auto below = above;
+					while( below != m_status.begin( ) && m_taken[*std::prev( below )] ) { --below; }
+					if( below != m_status.begin( ) ) { m_below = *std::prev( below ); }
+				}
+				for( size_t s : meeting ) { m_taken[s] = 0; }
+
+				// out and back in, ordered as they leave the event
+				for( size_t s : meeting ) {
+					if( m_active[s] ) {
+						m_status.erase( m_where[s] );
+						m_active[s] = 0;
+					}
+				}
+				inserted.clear( );
+				for( size_t s : meeting ) {
+					if( lexicographic_less( )( m_event, m_seg[s].r ) ) {
+						m_through[s] = 1;
+						inserted.push_back( s );
+					}
+				}
+				std::sort( inserted.begin( ), inserted.end( ), m_status.key_comp( ) );
+				for( size_t s : inserted ) {
+					m_where[s] = together ? m_status.insert( above, s ) : m_status.insert( s ).first;
+					m_active[s] = 1;
+				}
+
+				if( inserted.empty( ) ) {
+					if( m_below != none && m_above != none ) { check( m_below, m_above ); }
+				}
+				else {
+					// a rounded crossing can leave another segment through the
+					//   true point in between them, so each gets its neighbours
+					for( size_t s : inserted ) {
+						auto at = m_where[s];
+						if( at != m_status.begin( ) ) { check( *std::prev( at ), s ); }
+						if( std::next( at ) != m_status.end( ) ) { check( s, *std::next( at ) ); }
+					}
+				}
+				for( size_t s : inserted ) { m_through[s] = 0; }
+			}
+		}
+
+	private:
+
+		// A rounded crossing need not be exactly on the segments through the
+		//   true point, so the neighbours of those at the event that meet
+		//   them there, or run along them, are taken in as well
+		void gather( std::vector<size_t>& meeting ) {
+			for( size_t s : meeting ) { m_taken[s] = 1; }
+			for( size_t i = 0; i < meeting.size( ); ++i ) {
+				const size_t m = meeting[i];
+				if( !m_active[m] ) { continue; }
+				auto at = m_where[m];
+				if( at != m_status.begin( ) ) { take( *std::prev( at ), m, meeting ); }
+				if( std::next( at ) != m_status.end( ) ) { take( *std::next( at ), m, meeting ); }
+			}
+			for( size_t s : meeting ) { m_taken[s] = 0; }
+		}
+
+		void take( size_t e, size_t m, std::vector<size_t>& meeting ) {
+			if( m_taken[e] ) { return; }
+			point2<T> pt;
+			const convex::crossing c = meet( e, m, pt );
+			bool through = ( c == convex::crossing::overlap )
+				? lexicographic_less( )( m_event, m_seg[e].r )
+				: c != convex::crossing::none && ( same_point( pt, m_event ) || side( e, m_event ) == T(0) );
+
+			// or it goes through the true point of a crossing due here
+			const size_t n = m_seg.size( );
+			for( size_t i = 0; !through && c == convex::crossing::proper && i < m_queued.size( ); ++i ) {
+				const ends_t& a = m_seg[m_queued[i] / n];
+				const ends_t& b = m_seg[m_queued[i] % n];
+				through = concurrent( a.l, a.r, b.l, b.r, m_seg[e].l, m_seg[e].r );
+			}
+			if( through ) {
+				m_taken[e] = 1;
+				meeting.push_back( e );
+			}
+		}
+
+		// Every pair through the event that first meets there
+		template<typename Callback>
+		void report( const std::vector<size_t>& meeting, Callback& callback ) {
+			point2<T> pt;
+			for( size_t i = 0; i < meeting.size( ); ++i ) {
+				for( size_t j = i + 1; j < meeting.size( ); ++j ) {
+					const size_t a = meeting[i], b = meeting[j];
+					const convex::crossing c = meet( a, b, pt );
+					if( c == convex::crossing::none ) { continue; }
+
+					// a crossing is reported where it was queued for, or here if
+					//   it was never found as neighbours, as with three or more
+					//   through one point; these leave the event already crossed
+					if( c == convex::crossing::proper ) {
+						if( !std::binary_search( m_queued.begin( ), m_queued.end( ), key( a, b ) ) &&
+						    !m_known.insert( key( a, b ) ).second ) {
+							continue;
+						}
+					}
+					else if( !same_point( pt, m_event ) ) { continue; }
+					callback( a, b, pt );
+				}
+			}
+		}
+	};
+
+} } // End namespace detail::sweep
+
+
+////////////////////////////////////////
+// All intersecting pairs among the segments of [ first, last )
+//   callback( i, j, pt ) is called once for every pair i < j of indices
+//   into the range that meet, pt is where they first meet in sweep order
+
+template<typename InputIt, typename Callback>
+void segment_intersections( InputIt first, InputIt last, Callback callback ) {
+	typedef typename std::iterator_traits<InputIt>::value_type segment_t;
+	typedef typename std::decay<decltype( std::declval<segment_t>( ).base_point( )[0] )>::type T;
+
+	detail::sweep::bentley_ottmann<T> sweep( first, last );
+	sweep.run( callback );
+}
+
+template<typename T, typename Callback>
+void segment_intersections( const std::vector<segment2<T>>& segments, Callback callback ) {
+	segment_intersections( segments.begin( ), segments.end( ), callback );
+}
+
+
+////////////////////////////////////////
+// Where two lines in the plane cross
+//   solves a + s u = b + t v from the point and direction form, so the
+//   only division is by u x v, and a vertical line is nothing special;
+//   false when the lines are parallel, including when they coincide
+
+template<typename T>
+bool intersect( const line<T,2>& a, const line<T,2>& b, point2<T>& pt ) {
+	const T ux = a.base_vector( )[0], uy = a.base_vector( )[1];
+	const T vx = b.base_vector( )[0], vy = b.base_vector( )[1];
+	const T denom = ux * vy - uy * vx;
+	if( denom == T(0) ) { return false; }
+
+	const T dx = b.base_point( )[0] - a.base_point( )[0];
+	const T dy = b.base_point( )[1] - a.base_point( )[1];
+	const T s = ( dx * vy - dy * vx ) / denom;
+	pt = point2<T>( a.base_point( )[0] + s * ux, a.base_point( )[1] + s * uy );
+	return true;
+}
+
+// The closest points of two lines in space, pa on a and pb on b
+//   with n = u x v the segment between them is along n, which gives
+//   s = [ d v n ] / n.n and t = [ d u n ] / n.n for d = b - a;
+//   false when the lines are parallel
+template<typename T>
+bool closest_points( const line<T,3>& a, const line<T,3>& b, point<T,3>& pa, point<T,3>& pb ) {
+	const vector<T,3>& u = a.base_vector( );
+	const vector<T,3>& v = b.base_vector( );
+	const vector<T,3> n( u.cross( v ) );
+	const T denom = n.length_sq( );
+	if( denom == T(0) ) { return false; }
+
+	const vector<T,3> d( b.base_point( )[0] - a.base_point( )[0],
+	                     b.base_point( )[1] - a.base_point( )[1],
+	                     b.base_point( )[2] - a.base_point( )[2] );
+	const T s = scalar_triple( d, v, n ) / denom;
+	const T t = scalar_triple( d, u, n ) / denom;
+	for( std::size_t i = 0; i < 3; ++i ) {
+		pa[i] = a.base_point( )[i] + s * u[i];
+		pb[i] = b.base_point( )[i] + t * v[i];
+	}
+	return true;
+}
+
+// One line against many, as a scanline against the edges of a polygon
+//   t[i] is where along ln it crosses lines[i], ln.base_point( ) +
+//   t[i] ln.base_vector( ), which is left as the division by zero gives
+//   it when they are parallel, infinite or NaN, not finite either way; lines
+//   may be any of the line_base types, segments included, and only their
+//   lines are used.  Returns how many cross.
+template<typename T, typename Line>
+std::size_t intersect( const line<T,2>& ln, const Line* lines, std::size_t count, T* t ) {
+	static_assert( std::is_base_of<line_base<T,2>, Line>::value, "Line must be a line_base<T,2>" );
+	const T px = ln.base_point( )[0], py = ln.base_point( )[1];
+	const T rx = ln.base_vector( )[0], ry = ln.base_vector( )[1];
+
+	// no branches or selects, so the compiler vectorizes it
+	std::size_t crossing = 0;
+	for( std::size_t i = 0; i < count; ++i ) {
+		const T sx = lines[i].base_vector( )[0], sy = lines[i].base_vector( )[1];
+		const T dx = lines[i].base_point( )[0] - px, dy = lines[i].base_point( )[1] - py;
+		const T denom = rx * sy - ry * sx;
+		const T num   = dx * sy - dy * sx;
+		t[i] = num / denom;
+		crossing += ( denom != T(0) );
+	}
+	return crossing;
+}
+
+template<typename T, typename Line>
+std::size_t intersect( const line<T,2>& ln, const std::vector<Line>& lines, T* t ) {
+	return intersect( ln, lines.data( ), lines.size( ), t );
+}
+
+
+////////////////////////////////////////
+// A block of segments stored by coordinate
+//   segment i is ( px[i], py[i] ) + s ( vx[i], vy[i] ) for s in [ 0, 1 ],
+//   the same point and direction form as line_base
+
+template<typename T>
+class segment_block {
+// Typedefs
+public:
+
+	typedef std::size_t size_t;
+	enum { capacity = 64 };
+
+
+// Variables
+private:
+
+	alignas( 16 ) T m_px[capacity];
+	alignas( 16 ) T m_py[capacity];
+	alignas( 16 ) T m_vx[capacity];
+	alignas( 16 ) T m_vy[capacity];
+	size_t          m_size;
+
+
+// Constructors
+public:
+
+	// the unused slots are zeroed so whole packets can be read past size( )
+	segment_block( ) : m_px( ), m_py( ), m_vx( ), m_vy( ), m_size( 0 ) { }
+
+	// takes the first capacity segments of [ first, last )
+	template<typename InputIt>
+	segment_block( InputIt first, InputIt last ) : segment_block( ) {
+		for( ; first != last && m_size < capacity; ++first ) { push_back( *first ); }
+	}
+
+
+// Methods
+public:
+
+	size_t size( ) const { return m_size; }
+	bool empty( ) const  { return m_size == 0; }
+	bool full( ) const   { return m_size == capacity; }
+
+	void clear( ) { m_size = 0; }
+
+	void push_back( const line_base<T,2>& seg ) {
+		assert( m_size < capacity );
+		m_px[m_size] = seg.base_point( )[0];
+		m_py[m_size] = seg.base_point( )[1];
+		m_vx[m_size] = seg.base_vector( )[0];
+		m_vy[m_size] = seg.base_vector( )[1];
+		++m_size;
+	}
+
+	segment2<T> operator [] ( size_t i ) const {
+		assert( i < m_size );
+		return segment2<T>( point2<T>( m_px[i], m_py[i] ), vector2<T>( m_vx[i], m_vy[i] ) );
+	}
+
+	const T* px( ) const { return m_px; }
+	const T* py( ) const { return m_py; }
+	const T* vx( ) const { return m_vx; }
+	const T* vy( ) const { return m_vy; }
+
+}; // End class segment_block<T>
+
+
+namespace detail { namespace sweep {
+
+	// Parallel segments p + t r and q + u s, d = q - p
+	//   they meet only if collinear, t is where the query first reaches
+	//   the other, a point query is tested for lying on it
+	template<typename T>
+	bool parallel_hit( T rx, T ry, T dx, T dy, T sx, T sy, T& t ) {
+		t = T(0);
+		const T rr = rx * rx + ry * ry;
+		if( rr == T(0) ) {
+			const T ss = sx * sx + sy * sy;
+			const T along = -( dx * sx + dy * sy );
+			return sx * dy - sy * dx == T(0) && along >= T(0) && along <= ss &&
+			       ( ss != T(0) || ( dx == T(0) && dy == T(0) ) );
+		}
+		if( dx * ry - dy * rx != T(0) ) { return false; }
+
+		// the other's ends along r, scaled by rr until the end
+		const T t0 = dx * rx + dy * ry;
+		const T t1 = t0 + ( sx * rx + sy * ry );
+		const T lo = std::min( t0, t1 ), hi = std::max( t0, t1 );
+		if( lo > rr || hi < T(0) ) { return false; }
+		t = std::max( lo, T(0) ) / rr;
+		return true;
+	}
+
+} } // End namespace detail::sweep
+
+
+////////////////////////////////////////
+// One segment against a block of segments
+//   bit i of the result is set when seg meets block[i], and then t[i] is
+//   where along seg, seg.base_point( ) + t[i] seg.base_vector( ); t must
+//   have room for block.size( ) values
+
+template<typename T>
+std::uint64_t intersect( const segment2<T>& seg, const segment_block<T>& block, T* t ) {
+	typedef simd::packet<T>          packet_t;
+	typedef typename packet_t::type  type;
+	enum { capacity = segment_block<T>::capacity };
+
+	const T px = seg.base_point( )[0], py = seg.base_point( )[1];
+	const T rx = seg.base_vector( )[0], ry = seg.base_vector( )[1];
+
+	// with d = q - p, t = d x s / r x s and u = d x r / r x s
+	alignas( 16 ) T denom[capacity], tnum[capacity], unum[capacity], param[capacity];
+	const std::size_t count = block.size( );
+	const std::size_t padded = ( count + packet_t::size - 1 ) / packet_t::size * packet_t::size;
+	{
+		const type ppx = packet_t::set1( px ), ppy = packet_t::set1( py );
+		const type prx = packet_t::set1( rx ), pry = packet_t::set1( ry );
+		for( std::size_t j = 0; j < padded; j += packet_t::size ) {
+			const type dx = packet_t::sub( packet_t::load( block.px( ) + j ), ppx );
+			const type dy = packet_t::sub( packet_t::load( block.py( ) + j ), ppy );
+			const type sx = packet_t::load( block.vx( ) + j );
+			const type sy = packet_t::load( block.vy( ) + j );
+			const type d = packet_t::sub( packet_t::mul( prx, sy ), packet_t::mul( pry, sx ) );
+			const type tn = packet_t::sub( packet_t::mul( dx, sy ), packet_t::mul( dy, sx ) );
+			packet_t::store( denom + j, d );
+			packet_t::store( tnum + j, tn );
+			packet_t::store( unum + j, packet_t::sub( packet_t::mul( dx, pry ), packet_t::mul( dy, prx ) ) );
+			packet_t::store( param + j, packet_t::div( tn, d ) );
+		}
+	}
+
+	// 0 <= t, u <= 1 without dividing, flipped to a positive denominator;
+	//   kept free of branches so the compiler can vectorize it as well
+	std::uint64_t hits = 0;
+	bool parallel = false;
+	for( std::size_t i = 0; i < count; ++i ) {
+		const T d  = denom[i];
+		const T sd = d < T(0) ? -d : d;
+		const T tn = d < T(0) ? -tnum[i] : tnum[i];
+		const T un = d < T(0) ? -unum[i] : unum[i];
+		const bool hit = ( tn >= T(0) ) & ( tn <= sd ) & ( un >= T(0) ) & ( un <= sd ) & ( d != T(0) );
+		hits |= std::uint64_t( hit ) << i;
+		parallel |= ( d == T(0) );
+		t[i] = param[i];
+	}
+
+	if( parallel ) {
+		for( std::size_t i = 0; i < count; ++i ) {
+			if( denom[i] != T(0) ) { continue; }
+			const bool hit = detail::sweep::parallel_hit( rx, ry, block.px( )[i] - px, block.py( )[i] - py,
+			                                              block.vx( )[i], block.vy( )[i], t[i] );
+			hits |= std::uint64_t( hit ) << i;
+		}
+	}
+	return hits;
+}
+
+}  // End namespace euclib
+
+#endif // EUBLIB_INTERSECTION_HPP
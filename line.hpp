@@ -51,13 +51,11 @@ protected:
 protected: // cannot construct directly
 
 	line_base( ) { }
-	line_base( const line_base<T,D>& line ) { *this = line; }
-	line_base( line_base<T,D>&& line ) { *this = std::move( line ); }
+	line_base( const line_base<T,D>& line ) = default;
+	line_base( line_base<T,D>&& line ) = default;
 	line_base( const point<T,D>& pt1, const point<T,D>& pt2 ) : m_point(pt1), m_vector(pt2 - pt1) { }
 	line_base( const point<T,D>& pt, const vector<T,D>& vec ) : m_point( pt ), m_vector( vec ) { }
 
-	virtual ~line_base( ) { }
-
 // Methods
 public:
 
@@ -70,17 +68,8 @@ public:
 // Operators
 public:
 
-	line_base<T,D>& operator = ( const line_base<T,D>& line ) {
-		m_point = line.m_point;
-		m_vector = line.m_vector;
-		return *this;
-	}
-
-	line_base<T,D>& operator = ( line_base<T,D>&& line ) {
-		std::swap( m_point, line.m_point );
-		std::swap( m_vector, line.m_vector );
-		return *this;
-	}
+	line_base<T,D>& operator = ( const line_base<T,D>& line ) = default;
+	line_base<T,D>& operator = ( line_base<T,D>&& line ) = default;
 
 	// TODO: needs to be fixed, different for line and segment
 	bool operator == ( const line_base<T,D>& line ) const {
@@ -213,6 +202,18 @@ public:
 typedef line<float,2>         line2f;
 typedef line<double,2>        line2d;
 
+template<typename T> using line2 = line<T,2>;
+
+
+static_assert( std::is_trivially_copyable<line2f>::value &&
+               std::is_trivially_copyable<line<double,3>>::value,
+               "line must be trivially copyable" );
+static_assert( std::is_standard_layout<line2f>::value &&
+               std::is_standard_layout<line<double,3>>::value,
+               "line must be standard layout" );
+static_assert( sizeof(line2f) == 2*2*sizeof(float) &&
+               sizeof(line<double,3>) == 2*3*sizeof(double),
+               "line must be exactly the size of its point and vector" );
 
 }  // End namespace euclib
 
@@ -29,15 +29,133 @@
 #include <functional>
 #include <ctime>
 #include <typeinfo>
+#include <thread>
+#include <memory>
+#include <set>
 
 #include "point.hpp"
 #include "vector.hpp"
 #include "line.hpp"
 #include "segment.hpp"
+#include "point_cloud.hpp"
+#include "euclib_helper.hpp"
+#include "simple_polygon.hpp"
+#include "simplify.hpp"
+#include "spatial_hash.hpp"
 
 using namespace euclib;
 using namespace std;
 
+// Behaviour checks print what they test, the run fails if any of them do
+static int failures = 0;
+static void check( bool passed, const char* what ) {
+	cout << ( passed ? "ok:   " : "FAIL: " ) << what << "\n";
+	if( !passed ) { ++failures; }
+}
+
+static bool near( double a, double b, double tolerance = 1e-6 ) {
+	return std::abs( a - b ) <= tolerance;
+}
+
+// The hull vertices by brute force, sorted, a -> b is a counterclockwise
+//   hull edge when every point is left of it or on the segment
+static std::vector<point2d> brute_hull( const std::vector<point2d>& pts ) {
+	std::vector<point2d> vertices;
+	for( const point2d& a : pts ) {
+		for( const point2d& b : pts ) {
+			if( a == b ) { continue; }
+			bool edge = true;
+			for( std::size_t i = 0; edge && i < pts.size( ); ++i ) {
+				const point2d& p = pts[i];
+				const double turn = orient2d( a, b, p );
+				edge = turn > 0. || ( turn == 0. &&
+				       std::min( a.x( ), b.x( ) ) <= p.x( ) && p.x( ) <= std::max( a.x( ), b.x( ) ) &&
+				       std::min( a.y( ), b.y( ) ) <= p.y( ) && p.y( ) <= std::max( a.y( ), b.y( ) ) );
+			}
+			if( edge ) { vertices.push_back( a ); break; }
+		}
+	}
+	std::sort( vertices.begin( ), vertices.end( ), []( const point2d& l, const point2d& r ) {
+		return l.x( ) < r.x( ) || ( l.x( ) == r.x( ) && l.y( ) < r.y( ) );
+	} );
+	vertices.erase( std::unique( vertices.begin( ), vertices.end( ) ), vertices.end( ) );
+	return vertices;
+}
+
+// Shoelace area of a counterclockwise polygon
+static double shoelace_area( const std::vector<point2d>& poly ) {
+	double twice = 0.;
+	for( std::size_t i = 0; i < poly.size( ); ++i ) {
+		const point2d& a = poly[i];
+		const point2d& b = poly[( i + 1 ) % poly.size( )];
+		twice += a.x( ) * b.y( ) - b.x( ) * a.y( );
+	}
+	return twice / 2.;
+}
+
+// Every point of each set is within tolerance of one in the other
+static bool same_points( const std::vector<point2d>& lhs, const std::vector<point2d>& rhs, double tolerance ) {
+	auto covered = [tolerance]( const std::vector<point2d>& from, const std::vector<point2d>& to ) {
+		for( const point2d& p : from ) {
+			bool found = false;
+			for( std::size_t i = 0; !found && i < to.size( ); ++i ) {
+				found = near( p.x( ), to[i].x( ), tolerance ) && near( p.y( ), to[i].y( ), tolerance );
+			}
+			if( !found ) { return false; }
+		}
+		return true;
+	};
+	return covered( lhs, rhs ) && covered( rhs, lhs );
+}
+
+// Distance from p to the segment ab
+static double segment_distance( const point2d& p, const point2d& a, const point2d& b ) {
+	const double dx = b.x( ) - a.x( ), dy = b.y( ) - a.y( );
+	const double len_sq = dx * dx + dy * dy;
+	double t = len_sq > 0. ? ( ( p.x( ) - a.x( ) ) * dx + ( p.y( ) - a.y( ) ) * dy ) / len_sq : 0.;
+	t = std::max( 0., std::min( 1., t ) );
+	return std::hypot( p.x( ) - a.x( ) - t * dx, p.y( ) - a.y( ) - t * dy );
+}
+
+// Whether segments ab and cd share a point, collinear ones when their
+//   bounding boxes overlap
+static bool segments_meet( const point2d& a, const point2d& b, const point2d& c, const point2d& d ) {
+	const double abc = orient2d( a, b, c ), abd = orient2d( a, b, d );
+	const double cda = orient2d( c, d, a ), cdb = orient2d( c, d, b );
+	if( abc == 0. && abd == 0. && cda == 0. && cdb == 0. ) {
+		return std::max( a.x( ), b.x( ) ) >= std::min( c.x( ), d.x( ) ) && std::max( c.x( ), d.x( ) ) >= std::min( a.x( ), b.x( ) ) &&
+		       std::max( a.y( ), b.y( ) ) >= std::min( c.y( ), d.y( ) ) && std::max( c.y( ), d.y( ) ) >= std::min( a.y( ), b.y( ) );
+	}
+	return ( ( abc <= 0. && abd >= 0. ) || ( abc >= 0. && abd <= 0. ) ) &&
+	       ( ( cda <= 0. && cdb >= 0. ) || ( cda >= 0. && cdb <= 0. ) );
+}
+
+// Textbook recursive Douglas-Peucker, marks the points kept in [ i, j ]
+static void naive_douglas_peucker( const std::vector<point2d>& pts, std::size_t i, std::size_t j,
+                                   double tolerance, std::vector<bool>& keep ) {
+	double furthest = 0.;
+	std::size_t split = i;
+	for( std::size_t k = i + 1; k < j; ++k ) {
+		const double d = segment_distance( pts[k], pts[i], pts[j] );
+		if( d > furthest ) { furthest = d; split = k; }
+	}
+	if( furthest <= tolerance ) { return; }
+	keep[split] = true;
+	naive_douglas_peucker( pts, i, split, tolerance, keep );
+	naive_douglas_peucker( pts, split, j, tolerance, keep );
+}
+
+// The same vertices as the brute force hull, strictly counterclockwise
+static bool same_hull( std::vector<point2d> hull, const std::vector<point2d>& pts ) {
+	bool convex = true;
+	for( std::size_t i = 0; hull.size( ) > 2 && i < hull.size( ); ++i ) {
+		convex = convex && orient2d( hull[i], hull[( i + 1 ) % hull.size( )], hull[( i + 2 ) % hull.size( )] ) > 0.;
+	}
+	std::sort( hull.begin( ), hull.end( ), []( const point2d& l, const point2d& r ) {
+		return l.x( ) < r.x( ) || ( l.x( ) == r.x( ) && l.y( ) < r.y( ) );
+	} );
+	return convex && hull == brute_hull( pts );
+}
 
 // Takes an optional seed as an argument (to recreate bugs)
 int main( int argc, char *argv[] ) {
@@ -140,6 +258,986 @@ int main( int argc, char *argv[] ) {
 	     << "    " << s5.base_vector( )[0] << ", " << s5.base_vector( )[1] << "\n";
 
 
-	return 0;
+	// Point clouds
+	point_cloud2f c1 { std::vector<point2f>{ pt1, pt2, pt3 } };	// from points
+	point_cloud2f c2 { c1 };								// copy
+	point_cloud2f c3 ( 3 );									// sized
+	c3 = 3.f * ( c1 + c2 );									// expression
+	point2f pt7 { c3.element( 1 ) + pt4 };					// point from element
+	cout << "=== point cloud ===\n"
+	     << "c3:  " << c3.element( 0 )[0] << ", " << c3.element( 0 )[1]
+	     << "    " << c3.element( 1 )[0] << ", " << c3.element( 1 )[1]
+	     << "    " << c3.element( 2 )[0] << ", " << c3.element( 2 )[1] << "\n"
+	     << "pt7: " << pt7[0] << ", " << pt7[1] << "\n";
+
+	// an unsized cloud takes the size of the expression, and clouds only
+	//   mix with clouds of their dimension and scalars
+	point_cloud2f c4;
+	c4 = c1 - 2.f * c2;
+	bool c4_matches = c4.size( ) == c1.size( );
+	for( size_t i = 0; c4_matches && i < c1.size( ); ++i ) {
+		point2f expected { c1.element( i ) - 2.f * c2.element( i ) };
+		c4_matches = c4.element( i )[0] == expected[0] && c4.element( i )[1] == expected[1];
+	}
+	static_assert( !mpl::is_cloud_compatible<point_cloud2f,point2f::expression_t>::value, "cloud + point" );
+	static_assert( !mpl::is_cloud_compatible<point_cloud2f,point_cloud3f>::value, "2D + 3D cloud" );
+	static_assert( mpl::is_cloud_compatible<point_cloud2f,scalar<float>>::value, "cloud * scalar" );
+	check( c4_matches, "unsized cloud takes the expression's size and values" );
+
+	// Batch lengths, zero and overflowing vectors in both the packets and the tail
+	std::vector<vector3f> vs { vector3f( 0.f, 0.f, 0.f ), vector3f( 3.f, 4.f, 0.f ),
+	                           vector3f( 1e20f, 1e20f, 0.f ), vector3f( 1e-25f, 1e-25f, 0.f ),
+	                           vector3f( 1e20f, 1e20f, 0.f ), vector3f( 1e-25f, 1e-25f, 0.f ),
+	                           vector3f( 0.f, 0.f, 0.f ) };
+	std::vector<float> len_batch;
+	length( vs, len_batch );
+	cout << "=== batch length / normalize ===\n";
+	for( std::size_t i = 0; i < vs.size( ); ++i ) {
+		cout << "v" << i << ":  " << vs[i].length( ) << "    " << len_batch[i] << "\n";
+	}
+
+	// exact batch lengths match length( ) bit for bit
+	std::vector<vector2d> vd;
+	for( int i = 0; i < 1000; ++i ) { vd.push_back( vector2d( unif( ) - 5., unif( ) - 5. ) ); }
+	std::vector<double> len_d;
+	length( vd, len_d );
+	int mismatched = 0;
+	for( std::size_t i = 0; i < vd.size( ); ++i ) { mismatched += ( len_d[i] != vd[i].length( ) ); }
+	check( mismatched == 0, "batch length( ) equals vector::length( ) bit for bit" );
+
+	// batch normalize against dividing each vector by its length, and zero,
+	//   underflowing and overflowing squared lengths in the packets and the tail
+	std::vector<vector2d> nd( vd );
+	normalize( nd );
+	bool normalized = true;
+	for( std::size_t i = 0; i < vd.size( ); ++i ) {
+		const double l = vd[i].length( );
+		normalized = normalized && near( nd[i].x( ), vd[i].x( ) / l, 1e-15 ) &&
+		                           near( nd[i].y( ), vd[i].y( ) / l, 1e-15 );
+	}
+	check( normalized, "batch normalize( ) matches v / |v|" );
+	std::vector<vector3f> ns( vs );
+	normalize( ns );
+	bool edges_ok = ns[0].length_sq( ) == 0.f && ns[6].length_sq( ) == 0.f && near( ns[1].x( ), .6 );
+	for( std::size_t i : { 2, 3, 4, 5 } ) {
+		edges_ok = edges_ok && near( ns[i].x( ), std::sqrt( .5 ) ) && near( ns[i].y( ), std::sqrt( .5 ) );
+	}
+	check( edges_ok, "zero vectors normalize to zero, tiny and huge ones to unit length" );
+
+
+	// Rotate and mirror, clockwise turns +x toward +y, counterclockwise undoes it
+	//   the old counterclockwise matrix negated the wrong entries and mapped
+	//   (1,0) to (0,1), a reflection rather than a rotation
+	point2d origin { 0., 0. }, pivot { 2., -1. };
+	point2d r1 = rotate( point2d{ 1., 0. }, origin, 90.f, false );
+	point2d r2 = rotate( point2d{ 1., 0. }, origin, 90.f, true );
+	point2d r3 = rotate( rotate( point2d{ 3., 5. }, pivot, 37.f, true ), pivot, 37.f, false );
+	point2d m1 = mirror( point2d{ 1., 0. }, line2d{ origin, vector2d{ 1., 1. } } );
+	point2d m2 = mirror( point2d{ 3., 4. }, line2d{ point2d{ 0., 2. }, vector2d{ 5., 0. } } );
+	cout << "=== rotate / mirror ===\n";
+	check( near( r1.x( ), 0. ) && near( r1.y( ), -1. ), "ccw rotate (1,0) by 90 is (0,-1)" );
+	check( near( r2.x( ), 0. ) && near( r2.y( ), 1. ), "cw rotate (1,0) by 90 is (0,1)" );
+	check( near( r3.x( ), 3. ) && near( r3.y( ), 5. ), "ccw rotate undoes cw rotate about a pivot" );
+	check( near( m1.x( ), 0. ) && near( m1.y( ), 1. ), "mirror (1,0) over y = x is (0,1)" );
+	check( near( m2.x( ), 3. ) && near( m2.y( ), 0. ), "mirror (3,4) over y = 2 is (3,0)" );
+
+
+	// Polygon caches, const reads from several threads fill them once and
+	//   agree with a shoelace area over the vertices
+	polygon2d shared;
+	for( int i = 0; i < 500; ++i ) { shared.add_point( point2d( unif( ), unif( ) ) ); }
+	double areas[4];
+	std::size_t sizes[4];
+	std::vector<std::thread> readers;
+	for( int t = 0; t < 4; ++t ) {
+		readers.emplace_back( [&shared, &areas, &sizes, t]( ) {
+			areas[t] = shared.area( );
+			sizes[t] = shared.vertices( ).size( );
+		} );
+	}
+	for( auto& reader : readers ) { reader.join( ); }
+	const std::vector<point2d>& hull = shared.vertices( );
+	double shoelace = 0.;
+	for( std::size_t i = 0; i < hull.size( ); ++i ) {
+		const point2d& a = hull[i];
+		const point2d& b = hull[( i + 1 ) % hull.size( )];
+		shoelace += a.x( ) * b.y( ) - b.x( ) * a.y( );
+	}
+	bool readers_agree = true;
+	for( int t = 0; t < 4; ++t ) {
+		readers_agree = readers_agree && sizes[t] == hull.size( ) && near( areas[t], shoelace / 2., 1e-9 * shoelace );
+	}
+	cout << "=== polygon caches ===\n";
+	check( readers_agree, "concurrent const reads agree with the shoelace area" );
+
+	// Parallel hull, the blocks run on the pool and give the sequential hull
+	std::vector<point2d> cloud_pts( 1 << 18 );
+	for( auto& pt : cloud_pts ) { pt = point2d( unif( ), unif( ) ); }
+	std::vector<point2d> hull_seq = convex_hull( cloud_pts );
+	bool par_matches = true;
+	for( int run = 0; run < 4; ++run ) {
+		par_matches = par_matches && convex_hull( cloud_pts, execution::par ) == hull_seq;
+	}
+	cout << "=== parallel hull ===\n";
+	check( par_matches, "parallel hull on the pool equals the sequential hull" );
+
+	// Akl-Toussaint, every point the octagon drops is strictly inside the hull
+	std::vector<point2d> filtered( cloud_pts );
+	auto kept_end = akl_toussaint( filtered.begin( ), filtered.end( ) );
+	bool dropped_inside = true;
+	for( auto itr = kept_end; dropped_inside && itr != filtered.end( ); ++itr ) {
+		for( std::size_t i = 0; dropped_inside && i < hull_seq.size( ); ++i ) {
+			const point2d& a = hull_seq[i];
+			const point2d& b = hull_seq[( i + 1 ) % hull_seq.size( )];
+			dropped_inside = orient2d( a, b, *itr ) > 0.;
+		}
+	}
+	cout << "=== octagon prefilter ===\n";
+	check( dropped_inside && kept_end - filtered.begin( ) < 4096,
+	       "the octagon only drops points strictly inside the hull" );
+
+	// Lazy reductions over unevaluated expressions, against the same
+	//   formulas worked out coordinate by coordinate
+	vector3d ea { unif( ), unif( ), unif( ) }, eb { unif( ), unif( ), unif( ) };
+	vector3d ec { unif( ), unif( ), unif( ) }, ed { unif( ), unif( ), unif( ) };
+	double sum[3], diff[3];
+	for( int d = 0; d < 3; ++d ) { sum[d] = ea[d] + eb[d]; diff[d] = ec[d] - ed[d]; }
+	const double dot_ref = sum[0] * diff[0] + sum[1] * diff[1] + sum[2] * diff[2];
+	const double len_ref = std::sqrt( sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2] );
+	const double cross_ref[3] = { sum[1] * diff[2] - sum[2] * diff[1],
+	                              sum[2] * diff[0] - sum[0] * diff[2],
+	                              sum[0] * diff[1] - sum[1] * diff[0] };
+	const double lazy_dot = dot( ea + eb, ec - ed );
+	const double lazy_len = length( ea + eb );
+	vector3d lazy_norm { normalize( ea + eb ) };
+	vector3d lazy_cross { cross( ea + eb, ec - ed ) };
+	vector3d lazy_scaled { dot( ea + eb, ec - ed ) * ( ea - eb ) };
+	vector3d lazy_zero { normalize( ea - ea ) };
+	bool norm_ok = true, cross_ok = true, scaled_ok = true;
+	for( int d = 0; d < 3; ++d ) {
+		norm_ok   = norm_ok && near( lazy_norm[d], sum[d] / len_ref, 1e-12 );
+		cross_ok  = cross_ok && near( lazy_cross[d], cross_ref[d], 1e-12 );
+		scaled_ok = scaled_ok && near( lazy_scaled[d], dot_ref * ( ea[d] - eb[d] ), 1e-9 );
+	}
+	cout << "=== lazy reductions ===\n";
+	check( near( lazy_dot, dot_ref, 1e-12 ), "dot( a + b, c - d ) in one pass" );
+	check( near( lazy_len, len_ref, 1e-12 ), "length( a + b )" );
+	check( norm_ok, "normalize( a + b ) is ( a + b ) / |a + b|" );
+	check( cross_ok, "cross( a + b, c - d )" );
+	check( scaled_ok, "a reduction scales an expression" );
+	check( lazy_zero[0] == 0. && lazy_zero[1] == 0. && lazy_zero[2] == 0.,
+	       "a zero length expression normalizes to the zero vector" );
+
+	// Unrolled kernels at compile time, an 8 dimensional point built and
+	//   reduced in constant expressions, and the same at run time against
+	//   a plain loop over the coordinates
+	typedef euclib::vector<double,8> vector8d;
+	static constexpr point<double,8> p8 { 1., 2., 3., 4., 5., 6., 7., 8. };
+	static constexpr point<double,8> q8 { 2. * p8 - p8 };
+	constexpr vector8d v8 = [ ]( ) {
+		vector8d v { 1., 1., 1., 1. };	// the rest are zero
+		v += vector8d( p8 );
+		v *= 2.;
+		return v;
+	}( );
+	static_assert( q8 == p8, "constexpr expression evaluation" );
+	static_assert( v8[0] == 4. && v8[3] == 10. && v8[7] == 16., "constexpr += and *=" );
+	static_assert( v8.length_sq( ) == 912., "constexpr dot, 8D" );
+	static_assert( vector3d( 1., 2., 3. ).dot( vector3d( 4., 5., 6. ) ) == 32., "constexpr dot, 3D" );
+	vector8d r8, s8;
+	double dot8 = 0.;
+	for( std::size_t d = 0; d < 8; ++d ) { r8[d] = unif( ); s8[d] = unif( ); dot8 += r8[d] * s8[d]; }
+	vector8d t8 { r8 + 3. * s8 };
+	bool unrolled_ok = r8.dot( s8 ) == dot8;
+	for( std::size_t d = 0; d < 8; ++d ) { unrolled_ok = unrolled_ok && t8[d] == r8[d] + 3. * s8[d]; }
+	cout << "=== unrolled kernels ===\n";
+	check( unrolled_ok, "8D dot and expressions match a loop over the coordinates" );
+
+	// Predicates on near-degenerate input whose exact sign is known.  q and r
+	//   lie on y = x, so orient2d( p, q, r ) is 12 ( py - px ) for p on a grid
+	//   of ulps around ( 0.5, 0.5 ); every rectangle is cocircular, so moving
+	//   its fourth corner k ulps away from the center puts it outside
+	const double ulp = std::ldexp( 1., -53 );
+	int naive_wrong = 0, orient_wrong = 0;
+	for( int i = 0; i < 64; ++i ) {
+		for( int j = 0; j < 64; ++j ) {
+			const double px = .5 + i * ulp, py = .5 + j * ulp;
+			const double naive = ( px - 24. ) * ( 12. - 24. ) - ( py - 24. ) * ( 12. - 24. );
+			const int exact = ( j > i ) - ( j < i );
+			const double robust = orient2d( point2d{ px, py }, point2d{ 12., 12. }, point2d{ 24., 24. } );
+			naive_wrong  += ( ( naive > 0. ) - ( naive < 0. ) ) != exact;
+			orient_wrong += ( ( robust > 0. ) - ( robust < 0. ) ) != exact;
+		}
+	}
+	int naive_circle_wrong = 0, incircle_wrong = 0;
+	const double corners[][4] = { { .1, .3, 1.7, 2.9 }, { -3.3, .7, 1e3 + .1, 2e3 + .3 },
+	                              { 1e-3, -7.1, 13.7, 1e-2 }, { .3, .1, .7, .9 } };
+	for( const auto& rect : corners ) {
+		const double x0 = rect[0], y0 = rect[1], x1 = rect[2], y1 = rect[3];
+		for( int k = -3; k <= 3; ++k ) {
+			double dy = y1;
+			for( int step = 0; step < ( k < 0 ? -k : k ); ++step ) { dy = std::nextafter( dy, k < 0 ? -1e300 : 1e300 ); }
+			const double adx = x0 - x0, ady = y0 - dy, bdx = x1 - x0, bdy = y0 - dy, cdx = x1 - x0, cdy = y1 - dy;
+			const double naive = ( adx * adx + ady * ady ) * ( bdx * cdy - cdx * bdy )
+			                   + ( bdx * bdx + bdy * bdy ) * ( cdx * ady - adx * cdy )
+			                   + ( cdx * cdx + cdy * cdy ) * ( adx * bdy - bdx * ady );
+			const int exact = ( k < 0 ) - ( k > 0 );
+			const double robust = incircle( point2d{ x0, y0 }, point2d{ x1, y0 }, point2d{ x1, y1 }, point2d{ x0, dy } );
+			naive_circle_wrong += ( ( naive > 0. ) - ( naive < 0. ) ) != exact;
+			incircle_wrong     += ( ( robust > 0. ) - ( robust < 0. ) ) != exact;
+		}
+	}
+	cout << "=== predicates ===\n"
+	     << "naive orient2d wrong: " << naive_wrong << " of 4096, naive incircle wrong: "
+	     << naive_circle_wrong << " of 28\n";
+	check( naive_wrong > 0 && orient_wrong == 0, "orient2d gets every sign naive arithmetic misses" );
+	check( naive_circle_wrong > 0 && incircle_wrong == 0, "incircle gets every sign naive arithmetic misses" );
+
+	// Monotone chain hull against the brute force one, on small integer
+	//   grids full of duplicates and collinear points, and on a line
+	bool hulls_match = true;
+	for( int run = 0; run < 20; ++run ) {
+		std::vector<point2d> grid_pts( 150 );
+		for( auto& pt : grid_pts ) { pt = point2d( std::floor( unif( ) ), std::floor( unif( ) ) ); }
+		hulls_match = hulls_match && same_hull( convex_hull( grid_pts ), grid_pts );
+	}
+	std::vector<point2d> on_line;
+	for( int i = 0; i < 20; ++i ) { on_line.push_back( point2d( i % 7, 2 * ( i % 7 ) ) ); }
+	cout << "=== convex hull ===\n";
+	check( hulls_match, "hull of grid points equals the brute force hull" );
+	check( same_hull( convex_hull( on_line ), on_line ) && convex_hull( on_line ).size( ) == 2,
+	       "hull of collinear points is its two ends" );
+
+	// Incremental hull, after every few inserts the hull and containment
+	//   agree with the brute force hull of the points so far, and a polygon
+	//   streamed on top of a bulk hull ends with the hull of all of them
+	std::vector<point2d> stream_pts( 200 );
+	for( auto& pt : stream_pts ) { pt = point2d( std::floor( unif( ) ), std::floor( unif( ) ) ); }
+	incremental_hull<double> online;
+	bool online_matches = true, contains_matches = true;
+	for( std::size_t n = 1; n <= stream_pts.size( ); ++n ) {
+		online.insert( stream_pts[n-1] );
+		if( n % 10 != 0 ) { continue; }
+		const std::vector<point2d> prefix( stream_pts.begin( ), stream_pts.begin( ) + n );
+		std::vector<point2d> online_hull;
+		online.copy( std::back_inserter( online_hull ) );
+		online_matches = online_matches && online.size( ) == online_hull.size( ) && same_hull( online_hull, prefix );
+		for( int probe = 0; probe < 20 && online_hull.size( ) > 2; ++probe ) {
+			const point2d pt( std::floor( 2. * unif( ) ) / 2., std::floor( 2. * unif( ) ) / 2. );
+			bool inside = true;
+			for( std::size_t i = 0; i < online_hull.size( ); ++i ) {
+				inside = inside && orient2d( online_hull[i], online_hull[( i + 1 ) % online_hull.size( )], pt ) >= 0.;
+			}
+			contains_matches = contains_matches && online.contains( pt ) == inside;
+		}
+	}
+	polygon2d streamed( std::vector<point2d>( stream_pts.begin( ), stream_pts.begin( ) + 100 ) );
+	for( std::size_t i = 100; i < stream_pts.size( ); ++i ) { streamed.add_point( stream_pts[i] ); }
+	cout << "=== incremental hull ===\n";
+	check( online_matches, "incremental hull equals the brute force hull as it grows" );
+	check( contains_matches, "incremental contains( ) agrees with the edges of the hull" );
+	check( same_hull( streamed.vertices( ), stream_pts ), "polygon streamed after a bulk build has the full hull" );
+
+	// Point in convex polygon, the wedge search and the batch form against
+	//   the edges one by one, probing vertices, edge midpoints and the grid
+	//   around the hull as well as a point and a segment
+	bool single_matches = true, batch_matches = true;
+	for( int run = 0; run < 10; ++run ) {
+		std::vector<point2d> even_pts( 40 );
+		for( auto& pt : even_pts ) { pt = point2d( 2. * std::floor( unif( ) ), 2. * std::floor( unif( ) ) ); }
+		if( run == 0 ) { even_pts.resize( 1 ); }
+		if( run == 1 ) { even_pts = { point2d( 0., 0. ), point2d( 6., 4. ) }; }
+		polygon2d convex( even_pts );
+		const std::vector<point2d>& verts = convex.vertices( );
+		std::vector<point2d> probes;
+		for( int x = -1; x <= 21; ++x ) {
+			for( int y = -1; y <= 21; ++y ) { probes.push_back( point2d( x, y ) ); }
+		}
+		for( std::size_t i = 0; i < verts.size( ); ++i ) {
+			probes.push_back( verts[i] );
+			probes.push_back( point2d( ( verts[i].x( ) + verts[( i + 1 ) % verts.size( )].x( ) ) / 2.,
+			                           ( verts[i].y( ) + verts[( i + 1 ) % verts.size( )].y( ) ) / 2. ) );
+		}
+		std::unique_ptr<bool[]> mask( new bool[probes.size( )] );
+		convex.contains( probes.data( ), probes.size( ), mask.get( ) );
+		for( std::size_t k = 0; k < probes.size( ); ++k ) {
+			const point2d& pt = probes[k];
+			bool inside = true;
+			if( verts.size( ) == 1 ) { inside = pt == verts[0]; }
+			else if( verts.size( ) == 2 ) {
+				inside = orient2d( verts[0], verts[1], pt ) == 0. &&
+				         std::min( verts[0].x( ), verts[1].x( ) ) <= pt.x( ) && pt.x( ) <= std::max( verts[0].x( ), verts[1].x( ) ) &&
+				         std::min( verts[0].y( ), verts[1].y( ) ) <= pt.y( ) && pt.y( ) <= std::max( verts[0].y( ), verts[1].y( ) );
+			}
+			for( std::size_t i = 0; verts.size( ) > 2 && i < verts.size( ); ++i ) {
+				inside = inside && orient2d( verts[i], verts[( i + 1 ) % verts.size( )], pt ) >= 0.;
+			}
+			single_matches = single_matches && convex.contains( pt ) == inside;
+			batch_matches  = batch_matches && mask[k] == inside;
+		}
+	}
+	cout << "=== convex contains ===\n";
+	check( single_matches, "contains( point ) agrees with every edge" );
+	check( batch_matches, "batch contains( ) agrees with every edge" );
+
+	// Polygon metrics, a rectangle against its closed forms and a random hull
+	//   against a fan of triangles from its first vertex, then again after an
+	//   insert that moves the hull, which has to refill the cached values
+	polygon2d box( point2d( 1., 2. ), point2d( 5., 2. ), point2d( 5., 8. ), point2d( 1., 8. ) );
+	const polygon2d::moments_t box_m = box.second_moments( );
+	const bool box_ok = near( box.area( ), 24. ) && near( box.perimeter( ), 20. ) &&
+	                    near( box.centroid( ).x( ), 3. ) && near( box.centroid( ).y( ), 5. ) &&
+	                    near( box_m.ixx, 4. * 216. / 12. ) && near( box_m.iyy, 6. * 64. / 12. ) && near( box_m.ixy, 0. );
+	auto fan_matches = [ ]( const polygon2d& poly ) {
+		const std::vector<point2d>& v = poly.vertices( );
+		double area = 0., perimeter = 0., cx = 0., cy = 0., xx = 0., yy = 0., xy = 0.;
+		for( std::size_t i = 0; i < v.size( ); ++i ) {
+			const point2d& a = v[i];
+			const point2d& b = v[( i + 1 ) % v.size( )];
+			perimeter += std::hypot( b.x( ) - a.x( ), b.y( ) - a.y( ) );
+		}
+		for( std::size_t i = 1; i + 1 < v.size( ); ++i ) {
+			const point2d& a = v[0];
+			const point2d& b = v[i];
+			const point2d& c = v[i+1];
+			const double t = ( ( b.x( ) - a.x( ) ) * ( c.y( ) - a.y( ) ) - ( c.x( ) - a.x( ) ) * ( b.y( ) - a.y( ) ) ) / 2.;
+			area += t;
+			cx += t * ( a.x( ) + b.x( ) + c.x( ) ) / 3.;
+			cy += t * ( a.y( ) + b.y( ) + c.y( ) ) / 3.;
+			xx += t / 6. * ( a.x( ) * a.x( ) + b.x( ) * b.x( ) + c.x( ) * c.x( ) + a.x( ) * b.x( ) + b.x( ) * c.x( ) + c.x( ) * a.x( ) );
+			yy += t / 6. * ( a.y( ) * a.y( ) + b.y( ) * b.y( ) + c.y( ) * c.y( ) + a.y( ) * b.y( ) + b.y( ) * c.y( ) + c.y( ) * a.y( ) );
+			xy += t / 12. * ( 2. * ( a.x( ) * a.y( ) + b.x( ) * b.y( ) + c.x( ) * c.y( ) ) +
+			                  a.x( ) * b.y( ) + b.x( ) * a.y( ) + b.x( ) * c.y( ) + c.x( ) * b.y( ) + c.x( ) * a.y( ) + a.x( ) * c.y( ) );
+		}
+		cx /= area;
+		cy /= area;
+		const polygon2d::moments_t m = poly.second_moments( );
+		return near( poly.area( ), area, 1e-9 ) && near( poly.perimeter( ), perimeter, 1e-9 ) &&
+		       near( poly.centroid( ).x( ), cx, 1e-9 ) && near( poly.centroid( ).y( ), cy, 1e-9 ) &&
+		       near( m.ixx, yy - area * cy * cy, 1e-7 ) && near( m.iyy, xx - area * cx * cx, 1e-7 ) &&
+		       near( m.ixy, xy - area * cx * cy, 1e-7 );
+	};
+	polygon2d metric_poly;
+	for( int i = 0; i < 50; ++i ) { metric_poly.add_point( point2d( unif( ), unif( ) ) ); }
+	const bool fan_before = fan_matches( metric_poly );
+	const double area_before = metric_poly.area( );
+	metric_poly.add_point( point2d( 20., 20. ) );
+	const bool fan_after = fan_matches( metric_poly ) && metric_poly.area( ) > area_before;
+	cout << "=== polygon metrics ===\n";
+	check( box_ok, "rectangle area, perimeter, centroid and moments" );
+	check( fan_before, "hull metrics agree with a fan of triangles" );
+	check( fan_after, "an insert refills the cached metrics" );
+
+	// Convex intersection against the hull of every vertex inside the other
+	//   polygon and every crossing of two edges, on grid hulls that share
+	//   edges and vertices, nest, touch and miss each other
+	bool clips_match = true;
+	for( int run = 0; run < 200; ++run ) {
+		std::vector<point2d> p_pts( 6 ), q_pts( 6 );
+		for( auto& pt : p_pts ) { pt = point2d( std::floor( unif( ) ), std::floor( unif( ) ) ); }
+		for( auto& pt : q_pts ) { pt = point2d( std::floor( unif( ) ), std::floor( unif( ) ) ); }
+		if( run == 0 ) { q_pts = p_pts; }
+		const std::vector<point2d> p_hull = convex_hull( p_pts ), q_hull = convex_hull( q_pts );
+		if( p_hull.size( ) < 3 || q_hull.size( ) < 3 ) { continue; }
+		std::vector<point2d> clipped( p_hull.size( ) + q_hull.size( ) );
+		clipped.resize( convex_intersection( p_hull.begin( ), p_hull.end( ), q_hull.begin( ), q_hull.end( ),
+		                                     clipped.data( ) ) - clipped.data( ) );
+		auto inside = []( const std::vector<point2d>& poly, const point2d& pt ) {
+			for( std::size_t i = 0; i < poly.size( ); ++i ) {
+				if( orient2d( poly[i], poly[( i + 1 ) % poly.size( )], pt ) < 0. ) { return false; }
+			}
+			return true;
+		};
+		std::vector<point2d> candidates;
+		for( const point2d& pt : p_hull ) { if( inside( q_hull, pt ) ) { candidates.push_back( pt ); } }
+		for( const point2d& pt : q_hull ) { if( inside( p_hull, pt ) ) { candidates.push_back( pt ); } }
+		for( std::size_t i = 0; i < p_hull.size( ); ++i ) {
+			const point2d& a = p_hull[i];
+			const point2d& b = p_hull[( i + 1 ) % p_hull.size( )];
+			for( std::size_t j = 0; j < q_hull.size( ); ++j ) {
+				const point2d& c = q_hull[j];
+				const point2d& d = q_hull[( j + 1 ) % q_hull.size( )];
+				const double abc = orient2d( a, b, c ), abd = orient2d( a, b, d );
+				const double cda = orient2d( c, d, a ), cdb = orient2d( c, d, b );
+				if( abc * abd < 0. && cda * cdb < 0. ) {
+					const double t = cda / ( cda - cdb );
+					candidates.push_back( point2d( a.x( ) + t * ( b.x( ) - a.x( ) ), a.y( ) + t * ( b.y( ) - a.y( ) ) ) );
+				}
+			}
+		}
+		const std::vector<point2d> expected = convex_hull( candidates );
+		const bool area_ok = near( shoelace_area( clipped ), expected.size( ) > 2 ? shoelace_area( expected ) : 0., 1e-9 );
+		clips_match = clips_match && area_ok && same_points( clipped, expected, 1e-9 );
+	}
+	cout << "=== convex intersection ===\n";
+	check( clips_match, "convex intersection equals the brute force one" );
+
+	// GJK against brute force, two hulls overlap when a vertex of one is in
+	//   the other or two edges cross, otherwise they are as far apart as the
+	//   closest vertex and edge; squares sharing an edge touch
+	bool gjk_matches = true;
+	for( int run = 0; run < 200; ++run ) {
+		std::vector<point2d> a_pts( 8 ), b_pts( 8 );
+		const double shift = unif( ) - 5.;
+		for( auto& pt : a_pts ) { pt = point2d( unif( ) / 2., unif( ) / 2. ); }
+		for( auto& pt : b_pts ) { pt = point2d( unif( ) / 2. + shift, unif( ) / 2. + shift ); }
+		if( run == 0 ) {
+			a_pts = { point2d( 0., 0. ), point2d( 1., 0. ), point2d( 1., 1. ), point2d( 0., 1. ) };
+			b_pts = { point2d( 1., .5 ), point2d( 2., .5 ), point2d( 2., 1.5 ), point2d( 1., 1.5 ) };
+		}
+		const polygon2d shape_a( a_pts ), shape_b( b_pts );
+		const std::vector<point2d>& va = shape_a.vertices( );
+		const std::vector<point2d>& vb = shape_b.vertices( );
+		bool overlapping = false;
+		double closest = 1e300;
+		for( std::size_t i = 0; i < va.size( ); ++i ) {
+			const point2d& a0 = va[i];
+			const point2d& a1 = va[( i + 1 ) % va.size( )];
+			for( std::size_t j = 0; j < vb.size( ); ++j ) {
+				const point2d& b0 = vb[j];
+				const point2d& b1 = vb[( j + 1 ) % vb.size( )];
+				overlapping = overlapping || ( orient2d( a0, a1, b0 ) * orient2d( a0, a1, b1 ) <= 0. &&
+				                               orient2d( b0, b1, a0 ) * orient2d( b0, b1, a1 ) <= 0. );
+				closest = std::min( { closest, segment_distance( a0, b0, b1 ), segment_distance( b0, a0, a1 ) } );
+			}
+		}
+		overlapping = overlapping || shape_b.contains( va[0] ) || shape_a.contains( vb[0] );
+		const gjk_result<double> result = gjk( shape_a, shape_b );
+		gjk_matches = gjk_matches && result.converged && result.overlap == overlapping &&
+		              intersects( shape_a, shape_b ) == overlapping &&
+		              near( distance( shape_a, shape_b ), overlapping ? 0. : closest, 1e-9 );
+		if( !overlapping ) {
+			gjk_matches = gjk_matches &&
+			              near( std::hypot( result.on_a.x( ) - result.on_b.x( ), result.on_a.y( ) - result.on_b.y( ) ),
+			                    closest, 1e-9 );
+		}
+	}
+	const segment2d probe_seg( point2d( -1., 3. ), point2d( 3., -1. ) );
+	const polygon2d unit_box( point2d( 0., 0. ), point2d( 1., 0. ), point2d( 1., 1. ), point2d( 0., 1. ) );
+	cout << "=== gjk ===\n";
+	check( gjk_matches, "gjk overlap, distance and closest points match brute force" );
+	check( near( distance( point2d( 3., 3. ), unit_box ), std::sqrt( 8. ), 1e-12 ) && intersects( probe_seg, unit_box ),
+	       "gjk with a point and a segment" );
+
+	// Minkowski sum and difference against the brute force hull of every
+	//   pairwise sum, grid coordinates keep it all exact; one side is a
+	//   point or a segment in some runs
+	bool sums_match = true, differences_match = true;
+	for( int run = 0; run < 100; ++run ) {
+		std::vector<point2d> p_pts( 8 ), q_pts( 8 );
+		for( auto& pt : p_pts ) { pt = point2d( std::floor( unif( ) ), std::floor( unif( ) ) ); }
+		for( auto& pt : q_pts ) { pt = point2d( std::floor( unif( ) ), std::floor( unif( ) ) ); }
+		if( run == 0 ) { q_pts.resize( 1 ); }
+		if( run == 1 ) { q_pts = { point2d( 0., 0. ), point2d( 3., 2. ) }; }
+		const polygon2d poly_p( p_pts ), poly_q( q_pts );
+		std::vector<point2d> sums, differences;
+		for( const point2d& a : poly_p.vertices( ) ) {
+			for( const point2d& b : poly_q.vertices( ) ) {
+				sums.push_back( point2d( a.x( ) + b.x( ), a.y( ) + b.y( ) ) );
+				differences.push_back( point2d( a.x( ) - b.x( ), a.y( ) - b.y( ) ) );
+			}
+		}
+		sums_match = sums_match && same_hull( minkowski_sum( poly_p, poly_q ).vertices( ), sums );
+		differences_match = differences_match &&
+		                    same_hull( minkowski_difference( poly_p, poly_q ).vertices( ), differences );
+	}
+	cout << "=== minkowski ===\n";
+	check( sums_match, "minkowski sum is the hull of the pairwise sums" );
+	check( differences_match, "minkowski difference is the hull of the pairwise differences" );
+
+	// Rotating calipers against every pair of vertices and every edge:
+	//   the diameter is the furthest pair, the width the least of each
+	//   edge's furthest vertex, and the smallest rectangle the least of the
+	//   rectangles with a side along an edge, which holds every vertex
+	bool diameter_ok = true, width_ok = true, rect_ok = true;
+	for( int run = 0; run < 50; ++run ) {
+		std::vector<point2d> caliper_pts( 30 );
+		for( auto& pt : caliper_pts ) { pt = point2d( unif( ), unif( ) / 3. ); }
+		const std::vector<point2d> h = convex_hull( caliper_pts );
+		const std::size_t n = h.size( );
+		double far_sq = 0., thinnest = 1e300, least_area = 1e300;
+		for( std::size_t i = 0; i < n; ++i ) {
+			const point2d& a = h[i];
+			const point2d& b = h[( i + 1 ) % n];
+			const double len = std::hypot( b.x( ) - a.x( ), b.y( ) - a.y( ) );
+			const double ux = ( b.x( ) - a.x( ) ) / len, uy = ( b.y( ) - a.y( ) ) / len;
+			double lo = 1e300, hi = -1e300, up = 0.;
+			for( const point2d& p : h ) {
+				const double dx = p.x( ) - a.x( ), dy = p.y( ) - a.y( );
+				far_sq = std::max( far_sq, ( p.x( ) - a.x( ) ) * ( p.x( ) - a.x( ) ) + ( p.y( ) - a.y( ) ) * ( p.y( ) - a.y( ) ) );
+				lo = std::min( lo, dx * ux + dy * uy );
+				hi = std::max( hi, dx * ux + dy * uy );
+				up = std::max( up, dy * ux - dx * uy );
+			}
+			thinnest = std::min( thinnest, up );
+			least_area = std::min( least_area, ( hi - lo ) * up );
+		}
+		const segment2d diameter = convex_diameter( h.begin( ), h.end( ) );
+		const oriented_rect2<double> rect = min_area_rect( h.begin( ), h.end( ) );
+		bool holds_all = true;
+		for( const point2d& p : h ) {
+			const double dx = p.x( ) - rect.center.x( ), dy = p.y( ) - rect.center.y( );
+			for( int k = 0; k < 2; ++k ) {
+				holds_all = holds_all && std::abs( dx * rect.axis[k].x( ) + dy * rect.axis[k].y( ) ) <= rect.extent[k] + 1e-9;
+			}
+		}
+		diameter_ok = diameter_ok && near( diameter.length( ), std::sqrt( far_sq ), 1e-9 );
+		width_ok    = width_ok && near( convex_width( h.begin( ), h.end( ) ), thinnest, 1e-9 );
+		rect_ok     = rect_ok && holds_all && near( rect.area( ), least_area, 1e-9 );
+	}
+	cout << "=== rotating calipers ===\n";
+	check( diameter_ok, "diameter is the furthest pair of vertices" );
+	check( width_ok, "width is the thinnest edge-aligned strip" );
+	check( rect_ok, "min_area_rect holds the hull and is the least edge-aligned rectangle" );
+
+	// Triangulation of star shaped polygons with a hole and of a comb, the
+	//   triangles are counterclockwise, as many as promised, add up to the
+	//   area and cover every sample point inside the polygon exactly once
+	std::vector<simple_polygon2d> simples;
+	for( int run = 0; run < 10; ++run ) {
+		std::vector<point2d> star, hole;
+		for( int k = 0; k < 40; ++k ) {
+			const double angle = 2. * EUCLIB_PI * ( k + unif( ) / 20. ) / 40.;
+			const double radius = 6. + unif( );
+			star.push_back( point2d( radius * std::cos( angle ), radius * std::sin( angle ) ) );
+		}
+		for( int k = 0; k < 7; ++k ) {
+			const double angle = -2. * EUCLIB_PI * k / 7.;
+			const double radius = 1. + unif( ) / 5.;
+			hole.push_back( point2d( radius * std::cos( angle ) + .5, radius * std::sin( angle ) ) );
+		}
+		simples.push_back( simple_polygon2d( star ) );
+		if( run % 2 == 0 ) { simples.back( ).add_hole( hole ); }
+	}
+	std::vector<point2d> comb { point2d( 0., 0. ), point2d( 20., 0. ) };
+	for( int tooth = 9; tooth >= 0; --tooth ) {
+		comb.push_back( point2d( 2. * tooth + 1.5, 5. + tooth % 3 ) );
+		comb.push_back( point2d( 2. * tooth + 1., 1. ) );
+		comb.push_back( point2d( 2. * tooth + .5, 5. + tooth % 2 ) );
+	}
+	simples.push_back( simple_polygon2d( comb ) );
+	bool tri_count_ok = true, tri_area_ok = true, tri_cover_ok = true;
+	for( const simple_polygon2d& shape : simples ) {
+		std::vector<std::size_t> tris;
+		const std::size_t count = shape.triangulate( tris );
+		const std::vector<point2d>& v = shape.vertices( );
+		tri_count_ok = tri_count_ok && count == shape.size( ) + 2 * shape.holes( ) - 2 && tris.size( ) == 3 * count;
+		double total = 0.;
+		for( std::size_t t = 0; t < tris.size( ); t += 3 ) {
+			const double twice = orient2d( v[tris[t]], v[tris[t+1]], v[tris[t+2]] );
+			tri_count_ok = tri_count_ok && twice > 0.;
+			total += twice / 2.;
+		}
+		tri_area_ok = tri_area_ok && near( total, shape.area( ), 1e-9 * shape.area( ) );
+		const rect2d box = shape.bounding_box( );
+		for( double x = box.l + .0123; x < box.r; x += .37 ) {
+			for( double y = box.t + .0456; y < box.b; y += .41 ) {
+				const point2d pt( x, y );
+				int covering = 0;
+				for( std::size_t t = 0; t < tris.size( ); t += 3 ) {
+					covering += orient2d( v[tris[t]], v[tris[t+1]], pt ) > 0. &&
+					            orient2d( v[tris[t+1]], v[tris[t+2]], pt ) > 0. &&
+					            orient2d( v[tris[t+2]], v[tris[t]], pt ) > 0.;
+				}
+				tri_cover_ok = tri_cover_ok && covering == ( shape.contains( pt ) ? 1 : 0 );
+			}
+		}
+	}
+	cout << "=== triangulation ===\n";
+	check( tri_count_ok, "n + 2 holes - 2 counterclockwise triangles" );
+	check( tri_area_ok, "the triangles add up to the polygon's area" );
+	check( tri_cover_ok, "every sample point inside is in exactly one triangle" );
+
+	// Clipping star shaped polygons to rects and grids, against the fan of
+	//   triangles from the center each clipped by the convex intersection
+	auto fan_clip_area = [ ]( const point2d& center, const std::vector<point2d>& star, const rect2d& rect ) {
+		const point2d box[4] = { point2d( rect.l, rect.t ), point2d( rect.r, rect.t ),
+		                         point2d( rect.r, rect.b ), point2d( rect.l, rect.b ) };
+		double area = 0.;
+		for( std::size_t i = 0; i < star.size( ); ++i ) {
+			const point2d tri[3] = { center, star[i], star[( i + 1 ) % star.size( )] };
+			std::vector<point2d> piece( 7 );
+			piece.resize( convex_intersection( tri, tri + 3, box, box + 4, piece.data( ) ) - piece.data( ) );
+			if( piece.size( ) > 2 ) { area += shoelace_area( piece ); }
+		}
+		return area;
+	};
+	bool clip_area_ok = true, clip_inside_ok = true, tile_area_ok = true, tile_inside_ok = true;
+	for( int run = 0; run < 50; ++run ) {
+		const point2d center( unif( ), unif( ) );
+		std::vector<point2d> star;
+		for( int k = 0; k < 24; ++k ) {
+			const double angle = 2. * EUCLIB_PI * k / 24.;
+			const double radius = 1. + unif( ) / 2.;
+			star.push_back( point2d( center.x( ) + radius * std::cos( angle ), center.y( ) + radius * std::sin( angle ) ) );
+		}
+		const rect2d window( point2d( unif( ) - 1., unif( ) - 1. ), 1. + unif( ), 1. + unif( ) );
+		clip_buffer<double> clipped;
+		const double expected = fan_clip_area( center, star, window );
+		if( clip_polygon( star, window, clipped ) ) {
+			const std::vector<point2d> piece( clipped.begin( 0 ), clipped.end( 0 ) );
+			clip_area_ok = clip_area_ok && near( shoelace_area( piece ), expected, 1e-9 );
+			for( const point2d& pt : piece ) {
+				clip_inside_ok = clip_inside_ok && window.l <= pt.x( ) && pt.x( ) <= window.r &&
+				                                   window.t <= pt.y( ) && pt.y( ) <= window.b;
+			}
+		} else {
+			clip_area_ok = clip_area_ok && near( expected, 0., 1e-9 );
+		}
+
+		const rect2d grid( 0., 12., 0., 9. );
+		clip_buffer<double> tiles;
+		tile_polygon( star, grid, 4, 3, tiles );
+		double tiled = 0.;
+		for( std::size_t i = 0; i < tiles.size( ); ++i ) {
+			const std::vector<point2d> piece( tiles.begin( i ), tiles.end( i ) );
+			const double col = static_cast<double>( tiles.tile( i ) % 4 ), row = static_cast<double>( tiles.tile( i ) / 4 );
+			tiled += shoelace_area( piece );
+			for( const point2d& pt : piece ) {
+				tile_inside_ok = tile_inside_ok && 3. * col <= pt.x( ) && pt.x( ) <= 3. * col + 3. &&
+				                                   3. * row <= pt.y( ) && pt.y( ) <= 3. * row + 3.;
+			}
+		}
+		tile_area_ok = tile_area_ok && near( tiled, fan_clip_area( center, star, grid ), 1e-9 );
+	}
+	cout << "=== polygon clipping ===\n";
+	check( clip_area_ok, "clip_polygon keeps the area inside the rect" );
+	check( clip_inside_ok, "clipped vertices lie in the rect" );
+	check( tile_area_ok, "tile_polygon pieces add up to the area inside the grid" );
+	check( tile_inside_ok, "each tile piece lies in its tile" );
+
+	// Simplification of random walks against the textbook forms, Douglas-
+	//   Peucker recursing on the furthest point and Visvalingam-Whyatt
+	//   rescanning for the smallest triangle after every drop; a stream with
+	//   room for the whole track is the same, a short window keeps the ends
+	//   and a subsequence of the track
+	bool dp_matches = true, vw_matches = true, stream_matches = true, window_ok = true;
+	for( int run = 0; run < 20; ++run ) {
+		std::vector<point2d> track( 400 );
+		for( std::size_t i = 1; i < track.size( ); ++i ) {
+			track[i] = point2d( track[i-1].x( ) + unif( ) / 10. - .5, track[i-1].y( ) + unif( ) / 10. - .5 );
+		}
+		const double tolerance = .2 + unif( ) / 10., area = .05 + unif( ) / 50.;
+
+		std::vector<bool> keep( track.size( ), false );
+		keep.front( ) = keep.back( ) = true;
+		naive_douglas_peucker( track, 0, track.size( ) - 1, tolerance, keep );
+		std::vector<point2d> dp_expected;
+		for( std::size_t i = 0; i < track.size( ); ++i ) { if( keep[i] ) { dp_expected.push_back( track[i] ); } }
+		dp_matches = dp_matches && douglas_peucker( track, tolerance ) == dp_expected;
+
+		std::vector<point2d> vw_expected( track );
+		for( ;; ) {
+			double smallest = area;
+			std::size_t drop = 0;
+			for( std::size_t i = 1; i + 1 < vw_expected.size( ); ++i ) {
+				const double a = std::abs( orient2d( vw_expected[i-1], vw_expected[i], vw_expected[i+1] ) ) / 2.;
+				if( a < smallest ) { smallest = a; drop = i; }
+			}
+			if( drop == 0 ) { break; }
+			vw_expected.erase( vw_expected.begin( ) + drop );
+		}
+		const std::vector<point2d> vw = visvalingam_whyatt( track, area );
+		vw_matches = vw_matches && vw == vw_expected;
+
+		std::vector<point2d> whole, windowed;
+		visvalingam_stream<double,2> wide( area, 1024 ), narrow( area, 32 );
+		for( const point2d& pt : track ) {
+			wide.push( pt, std::back_inserter( whole ) );
+			narrow.push( pt, std::back_inserter( windowed ) );
+		}
+		wide.finish( std::back_inserter( whole ) );
+		narrow.finish( std::back_inserter( windowed ) );
+		stream_matches = stream_matches && whole == vw;
+		std::size_t at = 0;
+		for( const point2d& pt : windowed ) {
+			while( at < track.size( ) && !( track[at] == pt ) ) { ++at; }
+			window_ok = window_ok && at < track.size( );
+			++at;
+		}
+		window_ok = window_ok && windowed.front( ) == track.front( ) && windowed.back( ) == track.back( );
+	}
+	cout << "=== simplification ===\n";
+	check( dp_matches, "douglas_peucker equals the recursive form" );
+	check( vw_matches, "visvalingam_whyatt equals rescanning for the smallest triangle" );
+	check( stream_matches, "a stream with room for the track equals visvalingam_whyatt" );
+	check( window_ok, "a windowed stream keeps the ends and a subsequence of the track" );
+
+	// The sweep against every pair, on a small grid for shared ends, touching
+	//   and overlapping segments, then on random ones; the first run has
+	//   three segments through ( 1/3, 1/3 ), which does not round exactly
+	bool sweep_matches = true, sweep_once = true, sweep_on_both = true;
+	for( int run = 0; run < 40; ++run ) {
+		std::vector<point2d> ends;
+		if( run == 0 ) {
+			ends = { point2d( 0., 0. ), point2d( 1., 1. ), point2d( 1., 0. ), point2d( -1., 1. ),
+			         point2d( 0., 1. ), point2d( 1., -1. ) };
+		}
+		const bool grid = run < 20;
+		while( ends.size( ) < 120 ) {
+			const point2d a = grid ? point2d( std::floor( unif( ) * .7 ), std::floor( unif( ) * .7 ) ) : point2d( unif( ), unif( ) );
+			const point2d b = grid ? point2d( std::floor( unif( ) * .7 ), std::floor( unif( ) * .7 ) ) : point2d( unif( ), unif( ) );
+			if( a == b ) { continue; }
+			ends.push_back( a );
+			ends.push_back( b );
+		}
+		std::vector<segment2d> segments;
+		for( std::size_t i = 0; i < ends.size( ); i += 2 ) { segments.push_back( segment2d( ends[i], ends[i+1] ) ); }
+
+		const std::size_t n = segments.size( );
+		std::vector<int> seen( n * n, 0 );
+		segment_intersections( segments, [&]( std::size_t i, std::size_t j, const point2d& pt ) {
+			sweep_once = sweep_once && i < j && j < n && seen[i * n + j]++ == 0;
+			sweep_on_both = sweep_on_both && segment_distance( pt, ends[2*i], ends[2*i+1] ) < 1e-9 &&
+			                segment_distance( pt, ends[2*j], ends[2*j+1] ) < 1e-9;
+		} );
+		for( std::size_t i = 0; i < n; ++i ) {
+			for( std::size_t j = i + 1; j < n; ++j ) {
+				const bool meet = segments_meet( ends[2*i], ends[2*i+1], ends[2*j], ends[2*j+1] );
+				sweep_matches = sweep_matches && ( seen[i * n + j] != 0 ) == meet;
+			}
+		}
+	}
+	cout << "=== segment sweep ===\n";
+	check( sweep_matches, "the sweep finds the pairs that meet and no others" );
+	check( sweep_once, "the sweep reports each pair once, lower index first" );
+	check( sweep_on_both, "the sweep reports a point on both segments" );
+
+	// One segment against a block, every bit against the pair test and t at
+	//   a point on both; blocks of odd sizes leave a partial packet, the grid
+	//   gives shared ends and collinear overlaps, along with random segments
+	bool block_hits = true, block_params = true;
+	for( int run = 0; run < 40; ++run ) {
+		const bool grid = run < 20;
+		auto random_point = [&]( ) {
+			return grid ? point2d( std::floor( unif( ) * .7 ), std::floor( unif( ) * .7 ) ) : point2d( unif( ), unif( ) );
+		};
+		std::vector<point2d> ends;
+		const std::size_t count = 1 + std::size_t( unif( ) * 6.3 );
+		while( ends.size( ) < 2 * count ) {
+			const point2d a = random_point( ), b = random_point( );
+			if( a == b ) { continue; }
+			ends.push_back( a );
+			ends.push_back( b );
+		}
+		segment_block<double> block;
+		for( std::size_t i = 0; i < ends.size( ); i += 2 ) { block.push_back( segment2d( ends[i], ends[i+1] ) ); }
+
+		for( int query = 0; query < 20; ++query ) {
+			const point2d a = random_point( ), b = random_point( );
+			if( a == b ) { continue; }
+			double t[segment_block<double>::capacity];
+			const std::uint64_t hits = intersect( segment2d( a, b ), block, t );
+			for( std::size_t i = 0; i < count; ++i ) {
+				const bool hit = ( hits >> i ) & 1;
+				block_hits = block_hits && hit == segments_meet( a, b, ends[2*i], ends[2*i+1] );
+				if( hit ) {
+					const point2d at( a.x( ) + t[i] * ( b.x( ) - a.x( ) ), a.y( ) + t[i] * ( b.y( ) - a.y( ) ) );
+					block_params = block_params && t[i] >= -1e-12 && t[i] <= 1. + 1e-12 &&
+					               segment_distance( at, ends[2*i], ends[2*i+1] ) < 1e-9;
+				}
+			}
+			block_hits = block_hits && ( count == 64 || hits >> count == 0 );
+		}
+	}
+	cout << "=== segment block ===\n";
+	check( block_hits, "a block hits the segments the pair test does" );
+	check( block_params, "a block gives t at a point on both segments" );
+
+	// Lines against Cramer's rule on their implicit forms a x + b y = c, with
+	//   vertical and parallel ones among them, and the batch form against one
+	//   at a time; in space the closest points solve the normal equations of
+	//   | a + s u - b - t v |^2
+	bool lines_cross = true, lines_parallel = true, lines_batch = true, lines_closest = true;
+	for( int run = 0; run < 200; ++run ) {
+		const point2d p1( unif( ), unif( ) ), p2( unif( ), unif( ) );
+		point2d q1( unif( ), unif( ) ), q2( unif( ), unif( ) );
+		if( run % 10 == 0 ) { q2 = point2d( q1.x( ), q1.y( ) + 1. + unif( ) ); }
+		const line2d a( p1, p2 ), b( q1, q2 );
+		const double a1 = p2.y( ) - p1.y( ), b1 = p1.x( ) - p2.x( ), c1 = a1 * p1.x( ) + b1 * p1.y( );
+		const double a2 = q2.y( ) - q1.y( ), b2 = q1.x( ) - q2.x( ), c2 = a2 * q1.x( ) + b2 * q1.y( );
+		const double det = a1 * b2 - a2 * b1;
+		point2d pt;
+		if( intersect( a, b, pt ) ) {
+			const double x = ( b2 * c1 - b1 * c2 ) / det, y = ( a1 * c2 - a2 * c1 ) / det;
+			const double scale = 1. + std::abs( x ) + std::abs( y );
+			lines_cross = lines_cross && near( pt.x( ), x, 1e-9 * scale ) && near( pt.y( ), y, 1e-9 * scale );
+		}
+		else { lines_cross = false; }
+
+		const line2d shifted( point2d( p1.x( ) + 1., p1.y( ) ), a.base_vector( ) );
+		lines_parallel = lines_parallel && !intersect( a, shifted, pt ) && !intersect( a, a, pt );
+
+		const std::vector<line2d> others = { b, shifted, a, line2d( q1, p1 ) };
+		double t[4];
+		lines_batch = lines_batch && intersect( a, others, t ) == 2 && !std::isfinite( t[1] ) && !std::isfinite( t[2] );
+		for( std::size_t i : { std::size_t( 0 ), std::size_t( 3 ) } ) {
+			if( !intersect( a, others[i], pt ) ) { lines_batch = false; continue; }
+			const double x = p1.x( ) + t[i] * ( p2.x( ) - p1.x( ) ), y = p1.y( ) + t[i] * ( p2.y( ) - p1.y( ) );
+			const double scale = 1. + std::abs( x ) + std::abs( y );
+			lines_batch = lines_batch && near( pt.x( ), x, 1e-9 * scale ) && near( pt.y( ), y, 1e-9 * scale );
+		}
+
+		const point3d a0( unif( ), unif( ), unif( ) ), b0( unif( ), unif( ), unif( ) );
+		const vector3d u( unif( ) - 5., unif( ) - 5., unif( ) - 5. ), v( unif( ) - 5., unif( ) - 5., unif( ) - 5. );
+		const double uu = u.dot( u ), vv = v.dot( v ), uv = u.dot( v );
+		const double uw = u[0] * ( a0[0] - b0[0] ) + u[1] * ( a0[1] - b0[1] ) + u[2] * ( a0[2] - b0[2] );
+		const double vw = v[0] * ( a0[0] - b0[0] ) + v[1] * ( a0[1] - b0[1] ) + v[2] * ( a0[2] - b0[2] );
+		const double s_ref = ( uv * vw - vv * uw ) / ( uu * vv - uv * uv );
+		const double t_ref = ( uu * vw - uv * uw ) / ( uu * vv - uv * uv );
+		point3d pa, pb;
+		if( closest_points( line<double,3>( a0, u ), line<double,3>( b0, v ), pa, pb ) ) {
+			const double scale = 1. + std::abs( s_ref ) + std::abs( t_ref );
+			for( std::size_t d = 0; d < 3; ++d ) {
+				lines_closest = lines_closest && near( pa[d], a0[d] + s_ref * u[d], 1e-9 * scale ) &&
+				                near( pb[d], b0[d] + t_ref * v[d], 1e-9 * scale );
+			}
+		}
+		else { lines_closest = false; }
+		lines_closest = lines_closest && !closest_points( line<double,3>( a0, u ), line<double,3>( b0, vector3d( u * 2. ) ), pa, pb );
+	}
+	cout << "=== line intersection ===\n";
+	check( lines_cross, "crossing lines meet where Cramer's rule says" );
+	check( lines_parallel, "parallel and coincident lines do not meet" );
+	check( lines_batch, "the batch form agrees with one line at a time" );
+	check( lines_closest, "closest points in space solve the normal equations" );
+
+	// Liang-Barsky against points sampled along each segment, every sample
+	//   inside the rect lies in [ t0, t1 ] and every one well within it is
+	//   inside; grid ends give segments along the sides and through corners.
+	//   Lines reach the rect's sides, and the columns agree with one at a time
+	bool lb_segments = true, lb_lines = true, lb_columns = true;
+	for( int run = 0; run < 40; ++run ) {
+		const bool grid = run < 20;
+		const rect2d rect = grid ? rect2d( 2., 6., 2., 6. ) : rect2d( unif( ) / 2., 6. + unif( ) / 2., unif( ) / 2., 6. + unif( ) / 2. );
+		auto inside = [&]( double x, double y, double slack ) {
+			return x >= rect.l - slack && x <= rect.r + slack && y >= rect.t - slack && y <= rect.b + slack;
+		};
+		auto random_point = [&]( ) {
+			return grid ? point2d( std::floor( unif( ) * .9 ), std::floor( unif( ) * .9 ) ) : point2d( unif( ) * 1.4 - 2., unif( ) * 1.4 - 2. );
+		};
+		std::vector<double> px, py, vx, vy, t0s, t1s;
+		std::vector<bool> hits;
+		for( int i = 0; i < 50; ++i ) {
+			const point2d a = random_point( ), b = random_point( );
+			const segment2d seg( a, b );
+			double t0 = 2., t1 = -1.;
+			const bool hit = clip_segment( seg, rect, t0, t1 );
+			const double dx = seg.base_vector( )[0], dy = seg.base_vector( )[1];
+			for( int k = 0; k <= 1000; ++k ) {
+				const double t = k / 1000.;
+				const bool in = inside( a.x( ) + t * dx, a.y( ) + t * dy, 0. );
+				lb_segments = lb_segments && ( !in || ( hit && t >= t0 - 1e-9 && t <= t1 + 1e-9 ) );
+				lb_segments = lb_segments && ( !hit || t <= t0 + 1e-9 || t >= t1 - 1e-9 || in );
+			}
+			segment2d part;
+			lb_segments = lb_segments && clip_segment( seg, rect, part ) == hit;
+			if( hit ) {
+				const point2d& q = part.base_point( );
+				lb_segments = lb_segments && 0. <= t0 && t0 <= t1 && t1 <= 1. &&
+				              inside( q.x( ), q.y( ), 1e-9 ) &&
+				              inside( q.x( ) + part.base_vector( )[0], q.y( ) + part.base_vector( )[1], 1e-9 );
+			}
+			px.push_back( a.x( ) );
+			py.push_back( a.y( ) );
+			vx.push_back( dx );
+			vy.push_back( dy );
+			t0s.push_back( t0 );
+			t1s.push_back( t1 );
+			hits.push_back( hit );
+
+			// the clipped line's ends are on the rect, and it covers the line's
+			//   samples inside the rect
+			const line2d ln( a, b );
+			segment2d chord;
+			const bool crosses = clip_line( ln, rect, chord );
+			const point2d& c0 = chord.base_point( );
+			const point2d c1( c0.x( ) + chord.base_vector( )[0], c0.y( ) + chord.base_vector( )[1] );
+			auto on_side = [&]( const point2d& c ) {
+				return inside( c.x( ), c.y( ), 1e-9 ) && ( near( c.x( ), rect.l, 1e-9 ) || near( c.x( ), rect.r, 1e-9 ) ||
+				                                         near( c.y( ), rect.t, 1e-9 ) || near( c.y( ), rect.b, 1e-9 ) );
+			};
+			if( a == b ) { lb_lines = lb_lines && !crosses; continue; }
+			if( crosses ) { lb_lines = lb_lines && on_side( c0 ) && on_side( c1 ); }
+			for( int k = -2000; k <= 2000; ++k ) {
+				const double t = k / 100.;
+				const point2d q( a.x( ) + t * dx, a.y( ) + t * dy );
+				if( !inside( q.x( ), q.y( ), 0. ) ) { continue; }
+				lb_lines = lb_lines && crosses && segment_distance( q, c0, c1 ) < 1e-9;
+			}
+		}
+		std::vector<double> t0c( px.size( ) ), t1c( px.size( ) );
+		const std::size_t count = clip_segments( px.data( ), py.data( ), vx.data( ), vy.data( ), px.size( ), rect,
+		                                         t0c.data( ), t1c.data( ) );
+		lb_columns = lb_columns && count == std::size_t( std::count( hits.begin( ), hits.end( ), true ) );
+		for( std::size_t i = 0; i < px.size( ); ++i ) {
+			lb_columns = lb_columns && ( t0c[i] <= t1c[i] ) == hits[i] &&
+			             ( !hits[i] || ( near( t0c[i], t0s[i], 1e-12 ) && near( t1c[i], t1s[i], 1e-12 ) ) );
+		}
+	}
+	cout << "=== liang-barsky ===\n";
+	check( lb_segments, "a clipped segment is the sampled part inside the rect" );
+	check( lb_lines, "a clipped line runs side to side over the sampled part inside" );
+	check( lb_columns, "the column form agrees with one segment at a time" );
+
+	// The grid against a scan of every point, in the plane and in space, over
+	//   negative coordinates and repeated points; a point exactly radius away
+	//   counts, a radius wider than the points looks at all of them, and the
+	//   cells partition the points
+	bool grid_queries = true, grid_cells = true;
+	for( int run = 0; run < 20; ++run ) {
+		std::vector<point2d> flat( 300 );
+		for( auto& pt : flat ) { pt = point2d( unif( ) - 5., unif( ) - 5. ); }
+		for( std::size_t i = 0; i < 20; ++i ) { flat[i + 20] = flat[i]; }
+		flat[0] = point2d( 0., 0. );
+		flat[1] = point2d( 3., 4. );
+		std::vector<point3d> space( 300 );
+		for( auto& pt : space ) { pt = point3d( unif( ) - 5., unif( ) - 5., unif( ) - 5. ); }
+
+		const double cell = .5 + unif( ) / 10.;
+		const spatial_hash_grid2d grid2( cell, flat );
+		spatial_hash_grid3d grid3( cell );
+		grid3.build( space.begin( ), space.end( ) );
+
+		for( int query = 0; query < 30; ++query ) {
+			const double radius = query == 0 ? 5. : query == 1 ? 100. : unif( ) / 5.;
+			const point2d c2 = query < 2 ? point2d( 0., 0. ) : point2d( unif( ) - 5., unif( ) - 5. );
+			const point3d c3( unif( ) - 5., unif( ) - 5., unif( ) - 5. );
+			std::vector<std::size_t> expected2, expected3;
+			for( std::size_t i = 0; i < flat.size( ); ++i ) {
+				const double dx = flat[i].x( ) - c2.x( ), dy = flat[i].y( ) - c2.y( );
+				if( dx * dx + dy * dy <= radius * radius ) { expected2.push_back( i ); }
+			}
+			for( std::size_t i = 0; i < space.size( ); ++i ) {
+				const double dx = space[i][0] - c3[0], dy = space[i][1] - c3[1], dz = space[i][2] - c3[2];
+				if( dx * dx + dy * dy + dz * dz <= radius * radius ) { expected3.push_back( i ); }
+			}
+			std::vector<std::size_t> found2 = grid2.query( c2, radius ), found3;
+			grid3.query( c3, radius, found3 );
+			std::sort( found2.begin( ), found2.end( ) );
+			std::sort( found3.begin( ), found3.end( ) );
+			grid_queries = grid_queries && found2 == expected2 && found3 == expected3;
+			if( query == 0 ) { grid_queries = grid_queries && std::count( found2.begin( ), found2.end( ), 1u ) == 1; }
+			if( query == 1 ) { grid_queries = grid_queries && found2.size( ) == flat.size( ); }
+		}
+
+		std::vector<int> visits( flat.size( ), 0 );
+		std::set<spatial_hash_grid2d::cell_t> cells;
+		for( const point2d& pt : flat ) { cells.insert( grid2.cell_of( pt ) ); }
+		for( const auto& c : cells ) {
+			grid2.for_each_in_cell( c, [&]( std::size_t i ) {
+				++visits[i];
+				grid_cells = grid_cells && grid2.cell_of( flat[i] ) == c &&
+				             flat[i].x( ) >= c[0] * cell - 1e-9 && flat[i].x( ) <= ( c[0] + 1 ) * cell + 1e-9 &&
+				             flat[i].y( ) >= c[1] * cell - 1e-9 && flat[i].y( ) <= ( c[1] + 1 ) * cell + 1e-9;
+			} );
+		}
+		grid_cells = grid_cells && std::count( visits.begin( ), visits.end( ), 1 ) == int( flat.size( ) );
+	}
+	cout << "=== spatial hash ===\n";
+	check( grid_queries, "radius queries equal a scan of every point" );
+	check( grid_cells, "each point is in the one cell that holds it" );
+
+	return failures == 0 ? 0 : 1;
 }
 
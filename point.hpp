@@ -20,9 +20,11 @@
 #define EUBLIB_POINT_HPP
 
 #include <array>
+#include <utility>	// for std::index_sequence
 
 #include "type_traits.hpp"
 #include "euclib_math.hpp"
+#include "simd.hpp"
 #include "vector_expression.hpp"
 
 namespace euclib {
@@ -51,6 +53,8 @@ public:
 	typedef std::array<T,D> data_t;
 	typedef const T*        raw_data_t;
 
+	typedef simd::kernel<T,D> kernel_t;
+
 
 // Variables
 protected:
@@ -61,115 +65,116 @@ protected:
 // Constructors
 protected: // cannot construct directly
 
-	point_base( ) { }
-	point_base( const point_base<T,D>& pt ) { *this = pt; }
-	point_base( point_base<T,D>&& pt ) { *this = std::move( pt ); }
+	point_base( ) = default;
+	constexpr point_base( const point_base<T,D>& pt ) = default;
+	constexpr point_base( point_base<T,D>&& pt ) = default;
 	template<typename E>
-	point_base( const expression_holder<E>& expr ) { evaluate( expr ); }
+	constexpr point_base( const expression_holder<E>& expr ) : m_data( ) { evaluate( expr ); }
+	// missing coordinates are zero
 	template<typename ... Args>
-	point_base( T value, Args... values ) {
+	constexpr point_base( T value, Args... values ) : m_data{ { value, static_cast<T>( values )... } } {
 		static_assert( sizeof...(values) < D,
 		               "too many arguments to constructor" );
-		fill( 0, value, values... );
 	}
 
-	virtual ~point_base( ) { }
-
 
 // Methods
 public:
 
-	size_t dimension( ) const { return D; }
+	constexpr size_t dimension( ) const { return D; }
 
 
 protected:
 
-	template<typename ... Args>
-	inline void fill( std::size_t i, T value, Args... values ) {
-		m_data[i] = value;
-		fill( i + 1, values... );
-	}
-
-	inline void fill( std::size_t i ) {
-		for( ; i < D; ++i ) {
-			m_data[i] = 0;
-		}
-	}
-
 	template<typename E>
-	inline void evaluate( const expression_holder<E>& expr ) {
+	constexpr void evaluate( const expression_holder<E>& expr ) {
+		static_assert( mpl::cloud_dimension_of<E>::value == 0,
+		               "cannot assign a point cloud expression to a single point" );
 		const E& tmp( expr );
-		for( std::size_t i = 0; i < D; ++i ) {
-			m_data[i] = tmp[i];
-		}
+		// every coordinate is read before any is written, because
+		//   some expressions (cross_expr) read coordinates other than i
+		m_data = evaluate( tmp, std::make_index_sequence<D>( ) );
+	}
+
+	template<typename E, std::size_t... I>
+	static constexpr data_t evaluate( const E& expr, std::index_sequence<I...> ) {
+		return data_t{ { static_cast<T>( expr[I] )... } };
 	}
 
 // Operators
 public:
 
-	T operator [] ( std::size_t i ) const {
+	constexpr T operator [] ( std::size_t i ) const {
 		assert( i < D );
 		return m_data[i];
 	}
 
-	T& operator [] ( std::size_t i ) {
+	constexpr T& operator [] ( std::size_t i ) {
 		assert( i < D );
 		return m_data[i];
 	}
 
-	point_base<T,D>& operator = ( const point_base<T,D>& pt ) {
-		m_data = pt.m_data;
+	constexpr point_base<T,D>& operator = ( const point_base<T,D>& pt ) = default;
+	constexpr point_base<T,D>& operator = ( point_base<T,D>&& pt ) = default;
+
+	template<typename E>
+	constexpr point_base<T,D>& operator = ( const expression_holder<E>& expr ) {
+		evaluate( expr );
 		return *this;
 	}
 
-	point_base<T,D>& operator = ( point_base<T,D>&& pt ) {
-		std::swap( m_data, pt.m_data );
+	constexpr point_base<T,D>& operator += ( const point_base<T,D>& pt ) {
+		kernel_t::add( m_data.data( ), pt.m_data.data( ) );
 		return *this;
 	}
 
-	template<typename E>
-	point_base<T,D>& operator = ( const expression_holder<E>& expr ) {
-		evaluate( expr );
+	constexpr point_base<T,D>& operator -= ( const point_base<T,D>& pt ) {
+		kernel_t::sub( m_data.data( ), pt.m_data.data( ) );
 		return *this;
 	}
 
-	point_base<T,D>& operator += ( const point_base<T,D>& pt ) {
-		for( std::size_t i = 0; i < D; ++i ) {
-			m_data[i] += pt.m_data[i];
-		}
-		return *this;
+	template<typename E>
+	constexpr point_base<T,D>& operator += ( const expression_holder<E>& expr ) {
+		return *this += point_base<T,D>( expr );
 	}
 
-	template<typename R>
-	point_base<T,D>& operator -= ( const point_base<R,D>& pt ) {
-		for( std::size_t i = 0; i < D; ++i ) {
-			m_data[i] -= pt.m_data[i];
-		}
+	template<typename E>
+	constexpr point_base<T,D>& operator -= ( const expression_holder<E>& expr ) {
+		return *this -= point_base<T,D>( expr );
+	}
+
+	constexpr point_base<T,D>& operator *= ( T scalar ) {
+		kernel_t::mul( m_data.data( ), scalar );
 		return *this;
 	}
 
-	point_base<T,D>& operator *= ( T scalar ) {
-		for( std::size_t i = 0; i < D; ++i ) {
-			m_data[i] *= scalar;
-		}
+	constexpr point_base<T,D>& operator /= ( T scalar ) {
+		kernel_t::div( m_data.data( ), scalar );
 		return *this;
 	}
 
 }; // End class point_base<T,D>
 
 
+namespace mpl {
+	template<typename T, std::size_t D>
+	struct dimension_of<point_base<T,D>> : std::integral_constant<std::size_t, D> { };
+}
+
+
+template<typename T, std::size_t D, std::size_t... I>
+constexpr bool equal( const point_base<T,D>& lhs, const point_base<T,D>& rhs,
+                      std::index_sequence<I...> ) {
+	return ( ... && equal( lhs[I], rhs[I] ) );
+}
+
 template<typename T, std::size_t D>
-bool operator == ( const point_base<T,D>& lhs, const point_base<T,D>& rhs ) {
-	for( std::size_t i = 0; i < D; ++i ) {
-		if( !equal( lhs[i], rhs[i] ) ) {
-			return false;
-		}
-	}
-	return true;
+constexpr bool operator == ( const point_base<T,D>& lhs, const point_base<T,D>& rhs ) {
+	return equal( lhs, rhs, std::make_index_sequence<D>( ) );
 }
 
 template<typename T, std::size_t D>
-bool operator != ( const point_base<T,D>& lhs, const point_base<T,D>& rhs ) {
+constexpr bool operator != ( const point_base<T,D>& lhs, const point_base<T,D>& rhs ) {
 	return !(lhs == rhs);
 }
 
@@ -186,13 +191,13 @@ protected:
 // Constructors
 public:
 
-	point( ) : base_t( ) { }
-	point( const base_t& pt ) : base_t( pt ) { }
-	point( base_t&& pt ) : base_t( std::forward<base_t>( pt ) ) { }
+	constexpr point( ) : base_t( ) { }
+	constexpr point( const base_t& pt ) : base_t( pt ) { }
+	constexpr point( base_t&& pt ) : base_t( std::forward<base_t>( pt ) ) { }
 	template<typename E>
-	point( const expression_holder<E>& expr ) : base_t( expr ) { }
+	constexpr point( const expression_holder<E>& expr ) : base_t( expr ) { }
 	template<typename ... Args>
-	point( T value, Args... values ) : base_t( value, values... ) { }
+	constexpr point( T value, Args... values ) : base_t( value, values... ) { }
 
 }; // End class point<T,D>
 
@@ -208,24 +213,24 @@ protected:
 // Constructors
 public:
 
-	point( ) : base_t( ) { }
-	point( const base_t& pt ) : base_t( pt ) { }
-	point( base_t&& pt ) : base_t( std::forward<base_t>( pt ) ) { }
+	constexpr point( ) : base_t( ) { }
+	constexpr point( const base_t& pt ) : base_t( pt ) { }
+	constexpr point( base_t&& pt ) : base_t( std::forward<base_t>( pt ) ) { }
 	template<typename E>
-	point( const expression_holder<E>& expr ) : base_t( expr ) { }
-	point( T x ) : base_t( x ) { }
-	point( T x, T y ) : base_t( x, y ) { }
+	constexpr point( const expression_holder<E>& expr ) : base_t( expr ) { }
+	constexpr point( T x ) : base_t( x ) { }
+	constexpr point( T x, T y ) : base_t( x, y ) { }
 
 
 // Methods
 public:
 
-	T&  x( ) { return base_t::m_data[0]; }
-	T&  y( ) { return base_t::m_data[1]; }
-	T   x( ) const { return base_t::m_data[0]; }
-	T   y( ) const { return base_t::m_data[1]; }
+	constexpr T&  x( ) { return base_t::m_data[0]; }
+	constexpr T&  y( ) { return base_t::m_data[1]; }
+	constexpr T   x( ) const { return base_t::m_data[0]; }
+	constexpr T   y( ) const { return base_t::m_data[1]; }
 
-	const T* c_ptr( ) const { return base_t::m_data.data( ); }
+	constexpr const T* c_ptr( ) const { return base_t::m_data.data( ); }
 
 }; // End class point<T,2>
 
@@ -241,27 +246,27 @@ protected:
 // Constructors
 public:
 
-	point( ) : base_t( ) { }
-	point( const base_t& pt ) : base_t( pt ) { }
-	point( base_t&& pt ) : base_t( std::forward<base_t>( pt ) ) { }
+	constexpr point( ) : base_t( ) { }
+	constexpr point( const base_t& pt ) : base_t( pt ) { }
+	constexpr point( base_t&& pt ) : base_t( std::forward<base_t>( pt ) ) { }
 	template<typename E>
-	point( const expression_holder<E>& expr ) : base_t( expr ) { }
-	point( T x ) : base_t( x ) { }
-	point( T x, T y ) : base_t( x, y ) { }
-	point( T x, T y, T z ) : base_t( x, y, z ) { }
+	constexpr point( const expression_holder<E>& expr ) : base_t( expr ) { }
+	constexpr point( T x ) : base_t( x ) { }
+	constexpr point( T x, T y ) : base_t( x, y ) { }
+	constexpr point( T x, T y, T z ) : base_t( x, y, z ) { }
 
 
 // Methods
 public:
 
-	T&  x( ) { return base_t::m_data[0]; }
-	T&  y( ) { return base_t::m_data[1]; }
-	T&  z( ) { return base_t::m_data[2]; }
-	T   x( ) const { return base_t::m_data[0]; }
-	T   y( ) const { return base_t::m_data[1]; }
-	T   z( ) const { return base_t::m_data[2]; }
+	constexpr T&  x( ) { return base_t::m_data[0]; }
+	constexpr T&  y( ) { return base_t::m_data[1]; }
+	constexpr T&  z( ) { return base_t::m_data[2]; }
+	constexpr T   x( ) const { return base_t::m_data[0]; }
+	constexpr T   y( ) const { return base_t::m_data[1]; }
+	constexpr T   z( ) const { return base_t::m_data[2]; }
 
-	const T* c_ptr( ) const { return base_t::m_data.data( ); }
+	constexpr const T* c_ptr( ) const { return base_t::m_data.data( ); }
 
 }; // End class point<T,3>
 
@@ -277,30 +282,30 @@ protected:
 // Constructors
 public:
 
-	point( ) : base_t( ) { }
-	point( const base_t& pt ) : base_t( pt ) { }
-	point( base_t&& pt ) : base_t( std::forward<base_t>( pt ) ) { }
+	constexpr point( ) : base_t( ) { }
+	constexpr point( const base_t& pt ) : base_t( pt ) { }
+	constexpr point( base_t&& pt ) : base_t( std::forward<base_t>( pt ) ) { }
 	template<typename E>
-	point( const expression_holder<E>& expr ) : base_t( expr ) { }
-	point( T x ) : base_t( x ) { }
-	point( T x, T y ) : base_t( x, y ) { }
-	point( T x, T y, T z ) : base_t( x, y, z ) { }
-	point( T x, T y, T z, T w ) : base_t( x, y, z, w ) { }
+	constexpr point( const expression_holder<E>& expr ) : base_t( expr ) { }
+	constexpr point( T x ) : base_t( x ) { }
+	constexpr point( T x, T y ) : base_t( x, y ) { }
+	constexpr point( T x, T y, T z ) : base_t( x, y, z ) { }
+	constexpr point( T x, T y, T z, T w ) : base_t( x, y, z, w ) { }
 
 
 // Methods
 public:
 
-	T&  x( ) { return base_t::m_data[0]; }
-	T&  y( ) { return base_t::m_data[1]; }
-	T&  z( ) { return base_t::m_data[2]; }
-	T&  w( ) { return base_t::m_data[3]; }
-	T   x( ) const { return base_t::m_data[0]; }
-	T   y( ) const { return base_t::m_data[1]; }
-	T   z( ) const { return base_t::m_data[2]; }
-	T   w( ) const { return base_t::m_data[3]; }
+	constexpr T&  x( ) { return base_t::m_data[0]; }
+	constexpr T&  y( ) { return base_t::m_data[1]; }
+	constexpr T&  z( ) { return base_t::m_data[2]; }
+	constexpr T&  w( ) { return base_t::m_data[3]; }
+	constexpr T   x( ) const { return base_t::m_data[0]; }
+	constexpr T   y( ) const { return base_t::m_data[1]; }
+	constexpr T   z( ) const { return base_t::m_data[2]; }
+	constexpr T   w( ) const { return base_t::m_data[3]; }
 
-	const T* c_ptr( ) const { return base_t::m_data.data( ); }
+	constexpr const T* c_ptr( ) const { return base_t::m_data.data( ); }
 
 }; // End class point<T,4>
 
@@ -332,6 +337,27 @@ typedef point<decimal128,3>    point3d128;
 typedef point<decimal128,4>    point4d128;
 #endif
 
+template<typename T> using point2 = point<T,2>;
+template<typename T> using point3 = point<T,3>;
+template<typename T> using point4 = point<T,4>;
+
+
+// Points must stay plain values so arrays of them can be copied with memcpy,
+//   serialized and handed to SIMD code without per-element construction
+static_assert( std::is_trivially_copyable<point2f>::value &&
+               std::is_trivially_copyable<point3d>::value &&
+               std::is_trivially_copyable<point<double,8>>::value,
+               "point must be trivially copyable" );
+static_assert( std::is_standard_layout<point2f>::value &&
+               std::is_standard_layout<point3d>::value &&
+               std::is_standard_layout<point<double,8>>::value,
+               "point must be standard layout" );
+static_assert( sizeof(point2f) == 2*sizeof(float) &&
+               sizeof(point3d) == 3*sizeof(double) &&
+               sizeof(point4ld) == 4*sizeof(long double) &&
+               sizeof(point<double,8>) == 8*sizeof(double),
+               "point must be exactly the size of its coordinates" );
+
 }  // End namespace euclib
 
 #endif // EUBLIB_POINT_HPP
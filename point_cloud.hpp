@@ -0,0 +1,387 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_POINT_CLOUD_HPP
+#define EUBLIB_POINT_CLOUD_HPP
+
+#include <vector>
+#include <algorithm>
+#include <utility>	// for std::index_sequence
+#include <cassert>
+
+#include "type_traits.hpp"
+#include "point.hpp"
+#include "vector_expression.hpp"
+
+/*
+ * Structure-of-arrays storage for large sets of points
+ *
+ *   Each coordinate is stored in its own contiguous column and the columns are
+ *   laid out back to back, so coordinate d of point i lives at d*size( ) + i.
+ *   A point_cloud is an expression operand indexed by that flat position, which
+ *   lets a whole cloud expression run as one loop over D*size( ) values:
+ *
+ *     cloud_c = 3.f * ( cloud_a + cloud_b );
+ *
+ *   Every cloud in such an expression must have the same size, and the cloud
+ *   assigned to takes that size.  Clouds only mix with clouds of the same
+ *   dimension and scalars, anything else does not compile.  Single points
+ *   (element) and single coordinates (column) are available as views that can
+ *   be mixed with point/vector expressions and 1D clouds respectively.
+ */
+
+namespace euclib {
+
+////////////////////////////////////////
+// View of one point in a cloud
+//   T may be const for read-only access
+
+template<typename T, std::size_t D>
+class point_cloud_element : public expression_holder<point_cloud_element<T,D>> {
+// Variables
+	T*          m_first;   // first coordinate of the point
+	std::size_t m_stride;  // distance between coordinates
+
+// Typedefs
+public:
+	typedef typename std::remove_const<T>::type value_t;
+	typedef std::size_t                         size_t;
+
+// Constructors
+	point_cloud_element( T* first, size_t stride ) : m_first( first ), m_stride( stride ) { }
+	point_cloud_element( const point_cloud_element<T,D>& elem ) = default;
+
+// Methods
+	size_t dimension( ) const { return D; }
+
+private:
+
+	template<typename E>
+	inline void evaluate( const expression_holder<E>& expr ) {
+		static_assert( !std::is_const<T>::value, "cannot assign to a const element" );
+		static_assert( mpl::cloud_dimension_of<E>::value == 0,
+		               "cannot assign a point cloud expression to a single point" );
+		evaluate( static_cast<const E&>( expr ), std::make_index_sequence<D>( ) );
+	}
+
+	template<typename E, std::size_t... I>
+	inline void evaluate( const E& expr, std::index_sequence<I...> ) {
+		( ( m_first[I*m_stride] = expr[I] ), ... );
+	}
+
+// Operators
+public:
+	value_t operator [] ( size_t i ) const {
+		assert( i < D );
+		return m_first[i*m_stride];
+	}
+
+	T& operator [] ( size_t i ) {
+		assert( i < D );
+		return m_first[i*m_stride];
+	}
+
+	// assigns through to the cloud, does not rebind the view
+	point_cloud_element<T,D>& operator = ( const point_cloud_element<T,D>& elem ) {
+		evaluate( elem );
+		return *this;
+	}
+
+	template<typename E>
+	point_cloud_element<T,D>& operator = ( const expression_holder<E>& expr ) {
+		evaluate( expr );
+		return *this;
+	}
+};
+
+
+////////////////////////////////////////
+// View of one coordinate of every point in a cloud
+//   T may be const for read-only access
+
+template<typename T>
+class point_cloud_column : public expression_holder<point_cloud_column<T>> {
+// Variables
+	T*          m_data;
+	std::size_t m_size;
+
+// Typedefs
+public:
+	typedef typename std::remove_const<T>::type value_t;
+	typedef std::size_t                         size_t;
+
+// Constructors
+	point_cloud_column( T* data, size_t size ) : m_data( data ), m_size( size ) { }
+	point_cloud_column( const point_cloud_column<T>& col ) = default;
+
+// Methods
+	size_t size( ) const { return m_size; }
+
+	T* begin( ) const { return m_data; }
+	T* end( ) const   { return m_data + m_size; }
+
+private:
+
+	template<typename E>
+	inline void evaluate( const expression_holder<E>& expr ) {
+		static_assert( !std::is_const<T>::value, "cannot assign to a const column" );
+		static_assert( mpl::cloud_dimension_of<E>::value == 1 ||
+		               ( mpl::cloud_dimension_of<E>::value == 0 && mpl::dimension_of<E>::value == 0 ),
+		               "a column only takes columns, 1D clouds and scalars" );
+		const E& tmp( expr );
+		assert( detail::extent<E>::of( tmp ) == 0 || detail::extent<E>::of( tmp ) == m_size );
+		for( std::size_t i = 0; i < m_size; ++i ) {
+			m_data[i] = tmp[i];
+		}
+	}
+
+// Operators
+public:
+	value_t operator [] ( size_t i ) const {
+		assert( i < m_size );
+		return m_data[i];
+	}
+
+	T& operator [] ( size_t i ) {
+		assert( i < m_size );
+		return m_data[i];
+	}
+
+	// assigns through to the cloud, does not rebind the view
+	point_cloud_column<T>& operator = ( const point_cloud_column<T>& col ) {
+		evaluate( col );
+		return *this;
+	}
+
+	template<typename E>
+	point_cloud_column<T>& operator = ( const expression_holder<E>& expr ) {
+		evaluate( expr );
+		return *this;
+	}
+};
+
+// Views are created as temporaries, so expressions hold them by value
+template<typename T, std::size_t D>
+struct container<point_cloud_element<T,D>> { typedef point_cloud_element<T,D> ref_t; };
+
+template<typename T>
+struct container<point_cloud_column<T>> { typedef point_cloud_column<T> ref_t; };
+
+namespace mpl {
+	template<typename T, std::size_t D>
+	struct dimension_of<point_cloud_element<T,D>> : std::integral_constant<std::size_t, D> { };
+
+	template<typename T>
+	struct cloud_dimension_of<point_cloud_column<T>> : std::integral_constant<std::size_t, 1> { };
+}
+
+namespace detail {
+	template<typename T>
+	struct extent<point_cloud_column<T>> {
+		static std::size_t of( const point_cloud_column<T>& col ) { return col.size( ); }
+	};
+}
+
+
+////////////////////////////////////////
+// Structure-of-arrays point container
+
+template<typename T, std::size_t D>
+class point_cloud : public expression_holder<point_cloud<T,D>> {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	static_assert( std::is_floating_point<T>::value || mpl::is_decimal<T>::value,
+	               "T must be floating point or decimal" );
+	static_assert( D != 0, "Cannot have 0-dimensional object" );
+
+
+public:
+
+	typedef T                                 value_t;
+	typedef std::size_t                       size_t;
+	typedef point_cloud_element<T,D>          element_t;
+	typedef point_cloud_element<const T,D>    const_element_t;
+	typedef point_cloud_column<T>             column_t;
+	typedef point_cloud_column<const T>       const_column_t;
+
+
+// Variables
+private:
+
+	std::vector<T> m_data;  // D columns of m_size values each
+	std::size_t    m_size;
+
+
+// Constructors
+public:
+
+	point_cloud( ) : m_size( 0 ) { }
+	explicit point_cloud( size_t size ) : m_data( D*size ), m_size( size ) { }
+	point_cloud( const point_cloud<T,D>& cloud ) = default;
+	point_cloud( point_cloud<T,D>&& cloud ) : m_size( 0 ) { *this = std::move( cloud ); }
+	point_cloud( const std::vector<point<T,D>>& points ) :
+		m_data( D*points.size( ) ),
+		m_size( points.size( ) ) {
+		for( std::size_t i = 0; i < m_size; ++i ) {
+			for( std::size_t d = 0; d < D; ++d ) {
+				m_data[d*m_size + i] = points[i][d];
+			}
+		}
+	}
+
+
+// Methods
+public:
+
+	size_t size( ) const      { return m_size; }
+	size_t dimension( ) const { return D; }
+	bool   empty( ) const     { return m_size == 0; }
+
+	// keeps the first min(size, size( )) points, new points are zeroed
+	void resize( size_t size ) {
+		if( size == m_size ) { return; }
+
+		std::vector<T> data( D*size );
+		const size_t keep = std::min( size, m_size );
+		for( std::size_t d = 0; d < D; ++d ) {
+			std::copy( m_data.begin( ) + d*m_size, m_data.begin( ) + d*m_size + keep,
+			           data.begin( ) + d*size );
+		}
+		m_data.swap( data );
+		m_size = size;
+	}
+
+	void clear( ) {
+		m_data.clear( );
+		m_size = 0;
+	}
+
+	element_t element( size_t i ) {
+		assert( i < m_size );
+		return element_t( m_data.data( ) + i, m_size );
+	}
+
+	const_element_t element( size_t i ) const {
+		assert( i < m_size );
+		return const_element_t( m_data.data( ) + i, m_size );
+	}
+
+	column_t column( size_t d ) {
+		assert( d < D );
+		return column_t( m_data.data( ) + d*m_size, m_size );
+	}
+
+	const_column_t column( size_t d ) const {
+		assert( d < D );
+		return const_column_t( m_data.data( ) + d*m_size, m_size );
+	}
+
+	T* data( size_t d ) {
+		assert( d < D );
+		return m_data.data( ) + d*m_size;
+	}
+
+	const T* data( size_t d ) const {
+		assert( d < D );
+		return m_data.data( ) + d*m_size;
+	}
+
+
+private:
+
+	template<typename E>
+	inline void evaluate( const expression_holder<E>& expr ) {
+		static_assert( mpl::cloud_dimension_of<E>::value == D ||
+		               ( mpl::cloud_dimension_of<E>::value == 0 && mpl::dimension_of<E>::value == 0 ),
+		               "a cloud only takes clouds of its dimension and scalars" );
+		const E& tmp( expr );
+		const std::size_t size = detail::extent<E>::of( tmp );
+		if( size != 0 && size != m_size ) {
+			m_data.resize( D*size );
+			m_size = size;
+		}
+		T* data = m_data.data( );
+		const std::size_t n = m_data.size( );
+		for( std::size_t i = 0; i < n; ++i ) {
+			data[i] = tmp[i];
+		}
+	}
+
+
+// Operators
+public:
+
+	// flat access, coordinate d of point i is at d*size( ) + i
+	T operator [] ( std::size_t i ) const {
+		assert( i < m_data.size( ) );
+		return m_data[i];
+	}
+
+	T& operator [] ( std::size_t i ) {
+		assert( i < m_data.size( ) );
+		return m_data[i];
+	}
+
+	point_cloud<T,D>& operator = ( const point_cloud<T,D>& cloud ) {
+		m_data = cloud.m_data;
+		m_size = cloud.m_size;
+		return *this;
+	}
+
+	point_cloud<T,D>& operator = ( point_cloud<T,D>&& cloud ) {
+		std::swap( m_data, cloud.m_data );
+		std::swap( m_size, cloud.m_size );
+		return *this;
+	}
+
+	// takes the size of the expression's clouds
+	template<typename E>
+	point_cloud<T,D>& operator = ( const expression_holder<E>& expr ) {
+		evaluate( expr );
+		return *this;
+	}
+
+}; // End class point_cloud<T,D>
+
+
+namespace mpl {
+	template<typename T, std::size_t D>
+	struct cloud_dimension_of<point_cloud<T,D>> : std::integral_constant<std::size_t, D> { };
+}
+
+namespace detail {
+	template<typename T, std::size_t D>
+	struct extent<point_cloud<T,D>> {
+		static std::size_t of( const point_cloud<T,D>& cloud ) { return cloud.size( ); }
+	};
+}
+
+
+// Various typedefs to make usage easier
+typedef point_cloud<float,2>        point_cloud2f;
+typedef point_cloud<float,3>        point_cloud3f;
+
+typedef point_cloud<double,2>       point_cloud2d;
+typedef point_cloud<double,3>       point_cloud3d;
+
+}  // End namespace euclib
+
+#endif // EUBLIB_POINT_CLOUD_HPP
@@ -20,17 +20,32 @@
 #define EUBLIB_POLYGON_HPP
 
 #include <ostream>
+#include <iostream>
 #include <limits>
+#include <cmath>
+#include <type_traits>
 #include <complex>
 #include <vector>
 #include <algorithm>
+#include <iterator>
+#include <atomic>
+#include <mutex>
 #include <cassert>
+#include "simd.hpp"
 #include "point.hpp"
 #include "rect.hpp"
 #include "segment.hpp"
+#include "predicates.hpp"
+#include "hull.hpp"
+#include "convex.hpp"
 
 namespace euclib {
 
+////////////////////////////////////////
+// Convex polygon, kept as the hull of the points added to it
+//   the vertex list and the metrics are caches filled on first read,
+//   under a lock, so const members are safe to call from several threads
+
 template<typename T>
 class polygon2 {
 // Typedefs
@@ -43,25 +58,61 @@ protected:
 	static_assert( limit_t::is_specialized,
 	               "type not compatible with std::numeric_limits" );
 
+	// float sums of products lose too much over a long hull
+	typedef typename std::conditional<std::is_same<T,float>::value,
+	                                  double, T>::type accum_t;
+
+public:
+
+	// second moments of area about the centroid
+	struct moments_t {
+		T ixx;  // integral of y^2
+		T iyy;  // integral of x^2
+		T ixy;  // integral of x*y
+	};
+
+private:
+
+	struct metrics_t {
+		T         area;
+		T         perimeter;
+		point2<T> centroid;
+		moments_t moments;
+	};
+
 // Friend functions
 public:
 	// defined in euclib_helper.hpp
 	template<typename T_Ex> friend
 	polygon2<T_Ex> translate( const polygon2<T_Ex>& poly, T_Ex x, T_Ex y );
 	template<typename T_Ex> friend
-	polygon2<T_Ex> rotate( const polygon2<T_Ex>& target, const point2<T_Ex>& about, float angle, bool clockwise = true );
+	polygon2<T_Ex> rotate( const polygon2<T_Ex>& target, const point2<T_Ex>& about, float angle, bool clockwise );
 	template<typename T_Ex> friend
 	polygon2<T_Ex> mirror( const polygon2<T_Ex>& target, const line2<T_Ex>& over );
 	template<typename T_Ex> friend
 	point2<T_Ex> overlap( const point2<T_Ex>& pt, const polygon2<T_Ex>& poly );
 	template<typename T_Ex> friend
 	line2<T_Ex> overlap( const line2<T_Ex>& line, const polygon2<T_Ex>& poly );
+	template<typename T_Ex> friend
+	polygon2<T_Ex>& overlap( const polygon2<T_Ex>& poly1, const polygon2<T_Ex>& poly2,
+	                         polygon2<T_Ex>& result );
+	template<typename T_Ex> friend
+	polygon2<T_Ex>& minkowski_sum( const polygon2<T_Ex>& poly1, const polygon2<T_Ex>& poly2,
+	                               polygon2<T_Ex>& result );
+	template<typename T_Ex> friend
+	polygon2<T_Ex>& minkowski_difference( const polygon2<T_Ex>& poly1, const polygon2<T_Ex>& poly2,
+	                                      polygon2<T_Ex>& result );
 
 // Variables
 private:
 
-	std::vector<point2<T>>  m_hull;
-	rect2<T>                m_bounding_box;
+	mutable std::vector<point2<T>>  m_hull;          // behind m_stream while m_stale
+	rect2<T>                        m_bounding_box;
+	incremental_hull<T>             m_stream;        // hull of points added one at a time
+	mutable std::atomic<bool>       m_stale;
+	mutable metrics_t               m_metrics;
+	mutable std::atomic<bool>       m_metrics_valid; // false after any change to the hull
+	mutable std::mutex              m_cache_lock;    // held while a const read fills a cache
 
 	static T invalid; // holds either limit_t::infinity or limit_t::max
 
@@ -69,23 +120,26 @@ private:
 // Constructors
 public:
 
-	polygon2( ) {
+	polygon2( ) : m_stale( false ), m_metrics_valid( false ) {
 		m_hull.reserve( 3 ); // 3 is minimum to make polygon
 		set_null( );
 	}
-	polygon2( const polygon2<T>& poly ) { *this = poly; }
-	polygon2( polygon2<T>&& poly ) { *this = std::move( poly ); }
-	polygon2( const std::vector<point2<T>>& points ) { add_points( points ); }
+	polygon2( const polygon2<T>& poly ) : m_stale( false ), m_metrics_valid( false ) { *this = poly; }
+	polygon2( polygon2<T>&& poly ) : m_stale( false ), m_metrics_valid( false ) { *this = std::move( poly ); }
+	polygon2( const std::vector<point2<T>>& points ) : m_stale( false ), m_metrics_valid( false ) { add_points( points ); }
+	// the policy picks how the hull is built, see hull.hpp
+	template<typename Policy>
+	polygon2( const std::vector<point2<T>>& points, Policy policy ) : m_stale( false ), m_metrics_valid( false ) {
+		add_points( points, policy );
+	}
 
 	template<typename... Points>
-	polygon2( const point2<T>& point, const Points&... points ) {
-		m_hull.reserve( sizeof...(points) + 1 );
+	polygon2( const point2<T>& point, const Points&... points ) : m_stale( false ), m_metrics_valid( false ) {
 		add_points( point, points... );
 	}
 
 	template<typename... Points>
-	polygon2( point2<T>&& point, Points&&... points ) {
-		m_hull.reserve( sizeof...(points) + 1 );
+	polygon2( point2<T>&& point, Points&&... points ) : m_stale( false ), m_metrics_valid( false ) {
 		add_points( std::forward<point2<T>>( point ),
 		            std::forward<Points>( points )... );
 	}
@@ -104,185 +158,313 @@ public:
 	T width( ) const  { return m_bounding_box.width( ); }
 	T height( ) const { return m_bounding_box.height( ); }
 
-	// TODO: look at algorithm from ../polygon.cpp
-	float area( ) const {
-		std::cerr << "Error: polygon<T>::area( ) not implemented.\n";
-		return 0.f;
+	// The metrics are computed together in one pass over the hull
+	//   and cached until the hull changes
+	T area( ) const                { return metrics( ).area; }
+	T perimeter( ) const           { return metrics( ).perimeter; }
+	point2<T> centroid( ) const    { return metrics( ).centroid; }
+	moments_t second_moments( ) const { return metrics( ).moments; }
+
+	// Rotating calipers over the hull, O(n), see convex.hpp
+	segment2<T> diameter( ) const {
+		sync_hull( );
+		return convex_diameter( m_hull.begin( ), m_hull.end( ) );
 	}
-	float perimeter( ) const {
-		float perim = 0.f;
-		for( unsigned int i = 0; i < m_hull.size( ); ++i ) {
-			if( i + 1 == m_hull.size( ) ) {
-				perim += line2<T>( m_hull[i], m_hull[0] ).length( );
-			}
-			else {
-				perim += line2<T>( m_hull[i], m_hull[i+1] ).length( );
-			}
-		}
-		return perim;
+	T min_width( ) const {
+		sync_hull( );
+		return convex_width( m_hull.begin( ), m_hull.end( ) );
+	}
+	oriented_rect2<T> min_area_rect( ) const {
+		sync_hull( );
+		return euclib::min_area_rect( m_hull.begin( ), m_hull.end( ) );
 	}
 
 	rect2<T> bounding_box( ) const { return m_bounding_box; }
-	unsigned int size( ) const { return m_hull.size( ); }
+	unsigned int size( ) const { sync_hull( ); return m_hull.size( ); }
+
+	// the hull, counterclockwise from the lowest-leftmost vertex
+	const std::vector<point2<T>>& vertices( ) const { sync_hull( ); return m_hull; }
+
+	// Streaming insert, O(log n) amortized, see incremental_hull in hull.hpp
+	//   the vertex list is only rebuilt when it is next read
+	void add_point( const point2<T>& point ) {
+		if( m_stream.empty( ) ) {
+			for( auto itr = m_hull.begin( ); itr != m_hull.end( ); ++itr ) {
+				m_stream.insert( *itr );
+			}
+		}
+		if( m_stream.insert( point ) ) {
+			m_stale = true;
+			m_metrics_valid = false;
+		}
+		extend_bounding_box( point );
+	}
 
 	template<typename... Points>
 	void add_points( const point2<T>& point, const Points&... points ) {
-		if( point != point2<T>::null( ) ) {
-			m_hull.push_back( point );
-		}
+		add_point( point );
 		add_points( points... );
 	}
 
 	template<typename... Points>
 	void add_points( point2<T>&& point, Points&&... points ) {
-		if( point != point2<T>::null( ) ) {
-			m_hull.push_back( std::forward<point2<T>>( point ) );
-		}
+		add_point( point );
 		add_points( std::forward<Points>( points )... );
 	}
 
-	// TODO: calls graham_hull in sets of 100 because it chokes
-	//       on large data sets
-	void add_points( const std::vector<point2<T>>& points ) {
-		m_hull.reserve( points.size( ) );
-		unsigned int i;
-		for( unsigned int j = 1; j < points.size( ); ++j ) {
-			for( i = (j-1)*100; i < 100*j && i < points.size( ); ++i ) {
-				if( points[i] != point2<T>::null( ) ) {
-					m_hull.push_back( points[i] );
-				}
-			}
-			graham_hull( );
-		}
+	template<typename Policy = execution::sequenced_policy>
+	void add_points( const std::vector<point2<T>>& points, Policy policy = Policy( ) ) {
+		sync_hull( );
+		m_stream.clear( );
+		m_hull.insert( m_hull.end( ), points.begin( ), points.end( ) );
+		calc_hull( policy );
 		calc_bounding_box( );
+		m_metrics_valid = false;
 	}
 
 	point2<T> operator [] ( int index ) const {
+		sync_hull( );
 		return m_hull.at( index );
 	}
 
-private:
+	// Inside or on the boundary, O(log n)
+	bool contains( const point2<T>& pt ) const {
+		sync_hull( );
+		if( m_hull.size( ) < 3 ) {
+			// the bounding box test is all a point needs, a segment also
+			//   needs the point to be on its line
+			return in_bounding_box( pt ) &&
+			       ( m_hull.size( ) < 2 || orient2d( m_hull[0], m_hull[1], pt ) == T(0) );
+		}
 
-	void add_points( ) {
-		graham_hull( );
-		calc_bounding_box( );
+		std::size_t k = wedge( pt );
+		return k != 0 && orient2d( m_hull[k], m_hull[k+1], pt ) >= T(0);
 	}
 
-	T direction( const point2<T>& pt0, const point2<T>& pt1, const point2<T>& pt2 ) const {
-		return ( (pt1.x-pt0.x)*(pt2.y-pt0.y) - (pt1.y-pt0.y)*(pt2.x-pt0.x) );
-	}
+	// Batch form, mask[i] is set when points[i] is inside or on the boundary
+	//   the edge tests are gathered a block at a time and filtered with
+	//   packets, only the uncertain ones go through the exact orient2d
+	void contains( const point2<T>* points, std::size_t count, bool* mask ) const {
+		typedef simd::packet<T>          packet_t;
+		typedef typename packet_t::type  type;
 
-	// TODO: can probably implement the algorithm a little better
-	//       also segfaults (sometimes) on large (>1000) datasets
-	//       and all(?) the time on very large (>10000) datasets
-	void graham_hull( ) {
-		if( m_hull.size( ) < 3 ) { return; }
+		sync_hull( );
+		if( m_hull.size( ) < 3 ) {
+			for( std::size_t i = 0; i < count; ++i ) { mask[i] = contains( points[i] ); }
+			return;
+		}
 
-		// holds the points of the convex hull
-		std::vector<point2<T>> stack;
-		stack.reserve( m_hull.size( ) );
+		const std::size_t block = 64;
+		alignas( 16 ) T ax[block], ay[block], bx[block], by[block], px[block], py[block];
+		alignas( 16 ) T det[block], err[block];
+		std::size_t index[block];  // the point each pending edge test belongs to
+		const type bound = packet_t::set1( detail::predicates::constants<T>::orient2d_bound );
+
+		for( std::size_t first = 0; first < count; first += block ) {
+			const std::size_t last = std::min( count, first + block );
+
+			// find the edge to test for every point inside a wedge
+			std::size_t pending = 0;
+			for( std::size_t i = first; i < last; ++i ) {
+				mask[i] = false;
+				std::size_t k = wedge( points[i] );
+				if( k == 0 ) { continue; }
+				ax[pending] = m_hull[k].x( );   ay[pending] = m_hull[k].y( );
+				bx[pending] = m_hull[k+1].x( ); by[pending] = m_hull[k+1].y( );
+				px[pending] = points[i].x( );   py[pending] = points[i].y( );
+				index[pending++] = i;
+			}
+			const std::size_t padded = ( pending + packet_t::size - 1 ) / packet_t::size * packet_t::size;
+			for( std::size_t j = pending; j < padded; ++j ) {
+				ax[j] = ay[j] = bx[j] = by[j] = px[j] = py[j] = T(0);
+			}
 
-		// find the right/bottommost point
-		auto best = m_hull.begin( );
-		for( auto itr = m_hull.begin( ); itr != m_hull.end( ); ++itr ) {
-			if( best->y - itr->y > limit_t::epsilon( ) ) {
-				best = itr;
+			// the orient2d filter, a packet of points at a time
+			for( std::size_t j = 0; j < padded; j += packet_t::size ) {
+				type x = packet_t::load( px + j ), y = packet_t::load( py + j );
+				type l = packet_t::mul( packet_t::sub( packet_t::load( ax + j ), x ),
+				                        packet_t::sub( packet_t::load( by + j ), y ) );
+				type r = packet_t::mul( packet_t::sub( packet_t::load( ay + j ), y ),
+				                        packet_t::sub( packet_t::load( bx + j ), x ) );
+				packet_t::store( det + j, packet_t::sub( l, r ) );
+				packet_t::store( err + j, packet_t::mul( bound, packet_t::add( packet_t::abs( l ), packet_t::abs( r ) ) ) );
 			}
-			else if( std::abs(itr->y - best->y) <= limit_t::epsilon( ) &&
-			         best->x - itr->x > limit_t::epsilon( ) ) {
-				best = itr;
+
+			for( std::size_t j = 0; j < pending; ++j ) {
+				if( det[j] > err[j] )       { mask[index[j]] = true; }
+				else if( -det[j] > err[j] ) { mask[index[j]] = false; }
+				else {
+					mask[index[j]] = orient2d( ax[j], ay[j], bx[j], by[j], px[j], py[j] ) >= T(0);
+				}
 			}
+		}
+	}
+
+private:
+
+	bool in_bounding_box( const point2<T>& pt ) const {
+		return pt.x( ) >= m_bounding_box.l && pt.x( ) <= m_bounding_box.r &&
+		       pt.y( ) >= m_bounding_box.t && pt.y( ) <= m_bounding_box.b;
+	}
 
+	// The hull is a fan of triangles m_hull[0], m_hull[k], m_hull[k+1],
+	//   returns the k of the wedge holding pt or 0 if it is in none of them.
+	//   Binary search on the turn from m_hull[0], needs at least 3 vertices
+	std::size_t wedge( const point2<T>& pt ) const {
+		const std::size_t n = m_hull.size( );
+		if( !in_bounding_box( pt ) ||
+		    orient2d( m_hull[0], m_hull[1], pt ) < T(0) ||
+		    orient2d( m_hull[0], m_hull[n-1], pt ) > T(0) ) {
+			return 0;
 		}
 
-		// sort points by angle
-		struct sort_angle {
-			public:
-				sort_angle( const point2<T>& pt ) : best( pt ) { }
-
-				bool operator () ( const point2<T>& l, const point2<T>& r ) {
-					if( l == best ) { return true; }
-					else if( r == best ) { return false; }
-					float ang1 = atan2( l.y - best.y, l.x - best.x );
-					float ang2 = atan2( r.y - best.y, r.x - best.x );
-					// same angle
-					if( equal( ang1, ang2 ) ) {
-						if( equal( r.y, l.y ) ) {
-							return greater_than( r.x, l.x );
-						}
-						return greater_than( r.y, l.y );
-					}
-					return greater_than( ang2, ang1 );
-				}
+		std::size_t lo = 1, hi = n - 1;
+		while( hi - lo > 1 ) {
+			std::size_t mid = ( lo + hi ) / 2;
+			if( orient2d( m_hull[0], m_hull[mid], pt ) >= T(0) ) { lo = mid; }
+			else                                                 { hi = mid; }
+		}
+		return lo;
+	}
 
-			private:
-				point2<T> best;
-		};
-		std::sort( m_hull.begin( ), m_hull.end( ), sort_angle(*best) );
-
-		// these points are definitely in the hull
-		stack.push_back( *m_hull.begin( ) );
-		stack.push_back( *(m_hull.begin( ) + 1) );
-
-		// move through all points
-		for( auto itr = m_hull.begin( ) + 2; itr != m_hull.end( ); ++itr ) {
-			if( stack.size( ) < 2 ) { stack.push_back( *itr ); }
-			else {
-				// left turn
-				T dir = direction( *(stack.rbegin()+1), *stack.rbegin(), *itr );
-				if( greater_than( dir, T(0) ) ) {
-					stack.push_back( *itr );
-				}
-				// straight
-				else if( equal( dir, T(0) ) ) {
-					float d1 = segment2<T>( *(stack.rbegin( )+1), *itr ).length( );
-					float d2 = segment2<T>( *(stack.rbegin( )+1), *stack.rbegin( ) ).length( );
-					if( equal( d1, d2 ) ) {
-						stack.pop_back( );
-						--itr;
-					}
-				}
-				// right turn
-				else {
-					stack.pop_back( );
-					--itr;
-				}
+	void add_points( ) { }
+
+	// the flag is checked again once the lock is held, so a cache is
+	//   filled by one reader and the others wait for it
+	const metrics_t& metrics( ) const {
+		if( !m_metrics_valid.load( std::memory_order_acquire ) ) {
+			std::lock_guard<std::mutex> lock( m_cache_lock );
+			if( !m_metrics_valid.load( std::memory_order_relaxed ) ) {
+				fill_hull( );
+				calc_metrics( );
+				m_metrics_valid.store( true, std::memory_order_release );
 			}
 		}
+		return m_metrics;
+	}
+
+	// Green's theorem over the edges, relative to the first vertex so
+	//   the products stay small for hulls far from the origin
+	void calc_metrics( ) const {
+		const std::size_t n = m_hull.size( );
+		m_metrics = metrics_t{ T(0), T(0), point2<T>( ), moments_t{ T(0), T(0), T(0) } };
+		if( n == 0 ) { return; }
+
+		const accum_t ox = m_hull[0].x( );
+		const accum_t oy = m_hull[0].y( );
+		accum_t a = 0, cx = 0, cy = 0, ixx = 0, iyy = 0, ixy = 0;
+		accum_t perim = 0, sx = 0, sy = 0;
+		for( std::size_t i = 0; i < n; ++i ) {
+			const std::size_t j = ( i + 1 == n ) ? 0 : i + 1;
+			const accum_t x0 = m_hull[i].x( ) - ox, y0 = m_hull[i].y( ) - oy;
+			const accum_t x1 = m_hull[j].x( ) - ox, y1 = m_hull[j].y( ) - oy;
+			const accum_t cross = x0*y1 - x1*y0;
+
+			a   += cross;
+			cx  += ( x0 + x1 ) * cross;
+			cy  += ( y0 + y1 ) * cross;
+			ixx += ( y0*y0 + y0*y1 + y1*y1 ) * cross;
+			iyy += ( x0*x0 + x0*x1 + x1*x1 ) * cross;
+			ixy += ( x0*y1 + 2*x0*y0 + 2*x1*y1 + x1*y0 ) * cross;
+			perim += std::hypot( x1 - x0, y1 - y0 );
+			sx += x0;
+			sy += y0;
+		}
+
+		// fewer than 3 vertices, or all on a line
+		if( n < 3 || a == accum_t(0) ) {
+			if( n == 2 ) { perim /= 2; } // the closing edge doubles back
+			m_metrics.perimeter = static_cast<T>( perim );
+			m_metrics.centroid = point2<T>( static_cast<T>( ox + sx / n ),
+			                                static_cast<T>( oy + sy / n ) );
+			return;
+		}
+
+		a /= 2;
+		cx /= 6 * a;
+		cy /= 6 * a;
+		// parallel axis theorem, moments about the first vertex to the centroid
+		ixx = ixx / 12 - a * cy * cy;
+		iyy = iyy / 12 - a * cx * cx;
+		ixy = ixy / 24 - a * cx * cy;
+
+		m_metrics.area = static_cast<T>( a );
+		m_metrics.perimeter = static_cast<T>( perim );
+		m_metrics.centroid = point2<T>( static_cast<T>( ox + cx ), static_cast<T>( oy + cy ) );
+		m_metrics.moments = moments_t{ static_cast<T>( ixx ), static_cast<T>( iyy ),
+		                               static_cast<T>( ixy ) };
+	}
+
+	// after the vertices are moved in place by translate/rotate/mirror
+	//   puts the hull back in canonical order, ccw from the lowest-leftmost
+	void hull_changed( ) {
+		if( m_hull.size( ) >= 3 && orient2d( m_hull[0], m_hull[1], m_hull[2] ) < T(0) ) {
+			std::reverse( m_hull.begin( ), m_hull.end( ) );
+		}
+		std::rotate( m_hull.begin( ),
+		             std::min_element( m_hull.begin( ), m_hull.end( ), detail::lexicographic_less( ) ),
+		             m_hull.end( ) );
+		m_stream.clear( );
+		m_stale = false;
+		m_metrics_valid = false;
+		calc_bounding_box( );
+	}
+
+	void sync_hull( ) const {
+		if( !m_stale.load( std::memory_order_acquire ) ) { return; }
+		std::lock_guard<std::mutex> lock( m_cache_lock );
+		fill_hull( );
+	}
+
+	// m_cache_lock must be held
+	void fill_hull( ) const {
+		if( !m_stale.load( std::memory_order_relaxed ) ) { return; }
+		m_hull.clear( );
+		m_stream.copy( std::back_inserter( m_hull ) );
+		m_stale.store( false, std::memory_order_release );
+	}
+
+	// see hull.hpp, the old hull is part of the input
+	//   so points can be added to an existing polygon
+	template<typename Policy = execution::sequenced_policy>
+	void calc_hull( Policy policy = Policy( ) ) {
+		if( m_hull.size( ) < 3 ) { return; }
+		m_hull.erase( convex_hull( policy, m_hull.begin( ), m_hull.end( ) ), m_hull.end( ) );
+	}
 
-		m_hull = stack;
+	void extend_bounding_box( const point2<T>& pt ) {
+		if( m_bounding_box == rect2<T>::null( ) ) {
+			m_bounding_box = rect2<T>( pt.x( ), pt.x( ), pt.y( ), pt.y( ) );
+			return;
+		}
+		m_bounding_box.l = std::min( m_bounding_box.l, pt.x( ) );
+		m_bounding_box.r = std::max( m_bounding_box.r, pt.x( ) );
+		m_bounding_box.t = std::min( m_bounding_box.t, pt.y( ) );
+		m_bounding_box.b = std::max( m_bounding_box.b, pt.y( ) );
 	}
 
 	void calc_bounding_box( ) {
-		// best guess
+		if( m_hull.empty( ) ) {
+			set_null( );
+			return;
+		}
+
 		auto itr = m_hull.begin( );
-		T l = itr->x;
-		T r = itr->x;
-		T t = itr->y;
-		T b = itr->y;
+		T l = itr->x( );
+		T r = itr->x( );
+		T t = itr->y( );
+		T b = itr->y( );
 		for( ++itr ; itr != m_hull.end( ); ++itr ) {
-			// x
-			if( l - itr->x > limit_t::epsilon( ) ) {
-				l = itr->x;
-			}
-			else if( itr->x - r > limit_t::epsilon( ) ) {
-				r = itr->x;
-			}
-
-			// y
-			if( t - itr->y > limit_t::epsilon( ) ) {
-				t = itr->y;
-			}
-			else if( itr->y - b > limit_t::epsilon( ) ) {
-				b = itr->y;
-			}
+			l = std::min( l, itr->x( ) );
+			r = std::max( r, itr->x( ) );
+			t = std::min( t, itr->y( ) );
+			b = std::max( b, itr->y( ) );
 		}
 
 		m_bounding_box = rect2<T>( l, r, t, b );
 	}
 
 	void check_valid( ) {
-		std::remove( m_hull.begin( ), m_hull.end( ), point2<T>::null( ) );
 		if( m_hull.size( ) < 3 ) {
 			set_null( );
 		}
@@ -297,6 +479,9 @@ private:
 public:
 
 	bool operator == ( const polygon2<T>& poly ) const {
+		sync_hull( );
+		poly.sync_hull( );
+
 		// quick test for failure
 		if( m_bounding_box != poly.m_bounding_box ) { return false; }
 		// test for both null
@@ -313,7 +498,7 @@ public:
 		else if( m_hull.size( ) != poly.m_hull.size( ) ) { return false; }
 		// test every point
 		else {
-			// graham_hull( ) should have sorted these the same way
+			// calc_hull( ) should have ordered these the same way
 			for( unsigned int i = 0; i < m_hull.size( ); ++i ) {
 				if( m_hull[i] != poly.m_hull[i] ) { return false; }
 			}
@@ -325,29 +510,43 @@ public:
 		return !(*this == poly);
 	}
 
+	// the copy starts without a streaming hull, it is seeded
+	//   from the vertices on the next add_point( )
 	polygon2<T>& operator = ( const polygon2<T>& poly ) {
+		poly.sync_hull( );
 		m_bounding_box = poly.m_bounding_box;
 		m_hull = poly.m_hull;
+		m_stream.clear( );
+		m_stale = false;
+		std::lock_guard<std::mutex> lock( poly.m_cache_lock );
+		m_metrics = poly.m_metrics;
+		m_metrics_valid = poly.m_metrics_valid.load( std::memory_order_relaxed );
 		return *this;
 	}
 
 	polygon2<T>& operator = ( polygon2<T>&& poly ) {
 		std::swap( m_bounding_box, poly.m_bounding_box );
 		std::swap( m_hull, poly.m_hull );
+		std::swap( m_stream, poly.m_stream );
+		std::swap( m_metrics, poly.m_metrics );
+		m_stale = poly.m_stale.exchange( m_stale );
+		m_metrics_valid = poly.m_metrics_valid.exchange( m_metrics_valid );
 		return *this;
 	}
 
 	friend std::ostream& operator << ( std::ostream& stream, const polygon2<T>& poly ) {
+		poly.sync_hull( );
 		#ifdef GNUPLOT
 			for( unsigned int i = 0; i < poly.m_hull.size( ); ++i ) {
-				stream << poly.m_hull[i];
+				stream << poly.m_hull[i].x( ) << " " << poly.m_hull[i].y( ) << "\n";
 			}
-			stream << poly.m_hull[0];
+			stream << poly.m_hull[0].x( ) << " " << poly.m_hull[0].y( ) << "\n";
 			return stream << "e\n";
 		#else
 			stream << "Polygon: size = " << poly.m_hull.size( ) << "\n  ";
 			for( unsigned int i = 0; i < poly.m_hull.size( ); ++i ) {
-				stream << ( i != 0 ? "->" : "" ) << poly.m_hull[i];
+				stream << ( i != 0 ? "->" : "" )
+				       << "(" << poly.m_hull[i].x( ) << ", " << poly.m_hull[i].y( ) << ")";
 			}
 			return stream;
 		#endif
@@ -356,9 +555,8 @@ public:
 
 }; // End class polygon2<T>
 
-typedef polygon2<int>           polygon2i;
 typedef polygon2<float>         polygon2f;
-typedef polygon2<unsigned int>  polygon2u;
+typedef polygon2<double>        polygon2d;
 
 // Initialize invalid with either infinity or max
 template<typename T>
@@ -0,0 +1,439 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_PREDICATES_HPP
+#define EUBLIB_PREDICATES_HPP
+
+#include <cstddef>	// for std::size_t
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include "point.hpp"
+
+/*
+ * Robust orientation and incircle predicates
+ *
+ *   The sign of each result is always exact.  Following Shewchuk ("Adaptive
+ *   Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates"),
+ *   the determinant is first evaluated in T together with a bound on its
+ *   rounding error; only a result inside that bound is recomputed exactly
+ *   with expansion arithmetic.  The expansions live in fixed size buffers on
+ *   the stack, so no call allocates.
+ *
+ *   Exactness relies on IEEE round to nearest with no extended precision
+ *   and no contraction into fused multiply-adds, which is what gcc does for
+ *   -std=c++17 on SSE2 targets.  Do not build with -ffast-math.
+ */
+
+namespace euclib {
+
+namespace detail { namespace predicates {
+
+	template<typename T>
+	constexpr T pow2( int n ) {
+		T result( 1 );
+		for( int i = 0; i < n; ++i ) { result *= 2; }
+		return result;
+	}
+
+	template<typename T>
+	struct constants {
+		static_assert( std::is_floating_point<T>::value && std::numeric_limits<T>::radix == 2,
+		               "T must be a binary floating point type" );
+
+		// half an ulp of one, the relative error of a single operation
+		static constexpr T epsilon  = std::numeric_limits<T>::epsilon( ) / 2;
+		// 2^ceil(p/2) + 1, splits a value into halves whose products are exact
+		static constexpr T splitter = pow2<T>( ( std::numeric_limits<T>::digits + 1 ) / 2 ) + 1;
+
+		static constexpr T orient2d_bound = ( T(3)  + T(16) * epsilon ) * epsilon;
+		static constexpr T orient3d_bound = ( T(7)  + T(56) * epsilon ) * epsilon;
+		static constexpr T incircle_bound = ( T(10) + T(96) * epsilon ) * epsilon;
+	};
+
+
+	////////////////////////////////////////
+	// Error free transformations, x is the rounded result and y the error
+
+	template<typename T>
+	inline void fast_two_sum( T a, T b, T& x, T& y ) {  // requires |a| >= |b|
+		x = a + b;
+		y = b - ( x - a );
+	}
+
+	template<typename T>
+	inline void two_sum( T a, T b, T& x, T& y ) {
+		x = a + b;
+		T bv = x - a;
+		T av = x - bv;
+		y = ( a - av ) + ( b - bv );
+	}
+
+	template<typename T>
+	inline void two_diff( T a, T b, T& x, T& y ) {
+		x = a - b;
+		T bv = a - x;
+		T av = x + bv;
+		y = ( a - av ) + ( bv - b );
+	}
+
+	template<typename T>
+	inline void split( T a, T& hi, T& lo ) {
+		T c = constants<T>::splitter * a;
+		hi = c - ( c - a );
+		lo = a - hi;
+	}
+
+	template<typename T>
+	inline void two_product( T a, T b, T& x, T& y ) {
+		x = a * b;
+		T ahi, alo, bhi, blo;
+		split( a, ahi, alo );
+		split( b, bhi, blo );
+		T err = x - ahi * bhi;
+		err -= alo * bhi;
+		err -= ahi * blo;
+		y = alo * blo - err;
+	}
+
+
+	////////////////////////////////////////
+	// Expansion kernels
+	//   components are nonoverlapping, in increasing order of magnitude,
+	//   zeros are removed and every expansion has at least one component
+
+	// h = e + f, h must have room for elen + flen components
+	template<typename T>
+	std::size_t sum( const T* e, std::size_t elen, const T* f, std::size_t flen, T* h ) {
+		std::size_t ei = 0, fi = 0, hi = 0;
+		T enow = e[0], fnow = f[0];
+		T q, qnew, hh;
+
+		auto next_e = [&]( ) { ++ei; if( ei < elen ) { enow = e[ei]; } };
+		auto next_f = [&]( ) { ++fi; if( fi < flen ) { fnow = f[fi]; } };
+
+		if( ( fnow > enow ) == ( fnow > -enow ) ) { q = enow; next_e( ); }
+		else                                      { q = fnow; next_f( ); }
+
+		if( ei < elen && fi < flen ) {
+			if( ( fnow > enow ) == ( fnow > -enow ) ) { fast_two_sum( enow, q, qnew, hh ); next_e( ); }
+			else                                      { fast_two_sum( fnow, q, qnew, hh ); next_f( ); }
+			q = qnew;
+			if( hh != T(0) ) { h[hi++] = hh; }
+
+			while( ei < elen && fi < flen ) {
+				if( ( fnow > enow ) == ( fnow > -enow ) ) { two_sum( q, enow, qnew, hh ); next_e( ); }
+				else                                      { two_sum( q, fnow, qnew, hh ); next_f( ); }
+				q = qnew;
+				if( hh != T(0) ) { h[hi++] = hh; }
+			}
+		}
+		while( ei < elen ) {
+			two_sum( q, enow, qnew, hh ); next_e( );
+			q = qnew;
+			if( hh != T(0) ) { h[hi++] = hh; }
+		}
+		while( fi < flen ) {
+			two_sum( q, fnow, qnew, hh ); next_f( );
+			q = qnew;
+			if( hh != T(0) ) { h[hi++] = hh; }
+		}
+
+		if( q != T(0) || hi == 0 ) { h[hi++] = q; }
+		return hi;
+	}
+
+	// h = e * b, h must have room for 2 * elen components
+	template<typename T>
+	std::size_t scale( const T* e, std::size_t elen, T b, T* h ) {
+		std::size_t hi = 0;
+		T q, hh, product1, product0, s;
+
+		two_product( e[0], b, q, hh );
+		if( hh != T(0) ) { h[hi++] = hh; }
+		for( std::size_t ei = 1; ei < elen; ++ei ) {
+			two_product( e[ei], b, product1, product0 );
+			two_sum( q, product0, s, hh );
+			if( hh != T(0) ) { h[hi++] = hh; }
+			fast_two_sum( product1, s, q, hh );
+			if( hh != T(0) ) { h[hi++] = hh; }
+		}
+
+		if( q != T(0) || hi == 0 ) { h[hi++] = q; }
+		return hi;
+	}
+
+
+	////////////////////////////////////////
+	// Fixed capacity expansion, sizes are worked out at compile time
+
+	template<typename T, std::size_t N>
+	struct expansion {
+		T           data[N];
+		std::size_t size;
+
+		// the largest component carries the sign of the whole value
+		T most_significant( ) const { return data[size-1]; }
+	};
+
+	// a - b exactly
+	template<typename T>
+	inline expansion<T,2> difference( T a, T b ) {
+		expansion<T,2> result = { };
+		T x, y;
+		two_diff( a, b, x, y );
+		result.size = 0;
+		if( y != T(0) ) { result.data[result.size++] = y; }
+		result.data[result.size++] = x;
+		return result;
+	}
+
+	template<typename T, std::size_t N, std::size_t M>
+	inline expansion<T,N+M> operator + ( const expansion<T,N>& e, const expansion<T,M>& f ) {
+		expansion<T,N+M> result;
+		result.size = sum( e.data, e.size, f.data, f.size, result.data );
+		return result;
+	}
+
+	template<typename T, std::size_t N, std::size_t M>
+	inline expansion<T,N+M> operator - ( const expansion<T,N>& e, const expansion<T,M>& f ) {
+		expansion<T,M> neg( f );
+		for( std::size_t i = 0; i < neg.size; ++i ) { neg.data[i] = -neg.data[i]; }
+		return e + neg;
+	}
+
+	// sum of e scaled by every component of f
+	template<typename T, std::size_t N, std::size_t M>
+	expansion<T,2*N*M> operator * ( const expansion<T,N>& e, const expansion<T,M>& f ) {
+		expansion<T,2*N*M> result, tmp;
+		T scaled[2*N];
+
+		result.size = scale( e.data, e.size, f.data[0], result.data );
+		for( std::size_t i = 1; i < f.size; ++i ) {
+			std::size_t n = scale( e.data, e.size, f.data[i], scaled );
+			tmp.size = sum( result.data, result.size, scaled, n, tmp.data );
+			std::copy( tmp.data, tmp.data + tmp.size, result.data );
+			result.size = tmp.size;
+		}
+		return result;
+	}
+
+
+	////////////////////////////////////////
+	// Exact determinants, only reached when the filters cannot decide
+
+	template<typename T>
+	T orient2d_exact( T ax, T ay, T bx, T by, T cx, T cy ) {
+		auto acx = difference( ax, cx ), bcy = difference( by, cy );
+		auto acy = difference( ay, cy ), bcx = difference( bx, cx );
+		return ( acx * bcy - acy * bcx ).most_significant( );
+	}
+
+	template<typename T>
+	T turn2d_exact( T ax, T ay, T bx, T by, T cx, T cy, T dx, T dy ) {
+		auto abx = difference( bx, ax ), cdy = difference( dy, cy );
+		auto aby = difference( by, ay ), cdx = difference( dx, cx );
+		return ( abx * cdy - aby * cdx ).most_significant( );
+	}
+
+	template<typename T>
+	T orient3d_exact( T ax, T ay, T az, T bx, T by, T bz,
+	                  T cx, T cy, T cz, T dx, T dy, T dz ) {
+		auto adx = difference( ax, dx ), ady = difference( ay, dy ), adz = difference( az, dz );
+		auto bdx = difference( bx, dx ), bdy = difference( by, dy ), bdz = difference( bz, dz );
+		auto cdx = difference( cx, dx ), cdy = difference( cy, dy ), cdz = difference( cz, dz );
+
+		auto a = adz * ( bdx * cdy - cdx * bdy );
+		auto b = bdz * ( cdx * ady - adx * cdy );
+		auto c = cdz * ( adx * bdy - bdx * ady );
+		return ( a + b + c ).most_significant( );
+	}
+
+	template<typename T>
+	T incircle_exact( T ax, T ay, T bx, T by, T cx, T cy, T dx, T dy ) {
+		auto adx = difference( ax, dx ), ady = difference( ay, dy );
+		auto bdx = difference( bx, dx ), bdy = difference( by, dy );
+		auto cdx = difference( cx, dx ), cdy = difference( cy, dy );
+
+		auto a = ( adx * adx + ady * ady ) * ( bdx * cdy - cdx * bdy );
+		auto b = ( bdx * bdx + bdy * bdy ) * ( cdx * ady - adx * cdy );
+		auto c = ( cdx * cdx + cdy * cdy ) * ( adx * bdy - bdx * ady );
+		return ( a + b + c ).most_significant( );
+	}
+
+} } // End namespace detail::predicates
+
+
+////////////////////////////////////////
+// Predicates on raw coordinates
+//   for callers that keep their points in other layouts
+
+template<typename T>
+inline T orient2d( T ax, T ay, T bx, T by, T cx, T cy ) {
+	typedef detail::predicates::constants<T> constants_t;
+
+	T detleft  = ( ax - cx ) * ( by - cy );
+	T detright = ( ay - cy ) * ( bx - cx );
+	T det = detleft - detright;
+
+	// when the products differ in sign the subtraction cannot cancel
+	T detsum;
+	if( detleft > T(0) ) {
+		if( detright <= T(0) ) { return det; }
+		detsum = detleft + detright;
+	}
+	else if( detleft < T(0) ) {
+		if( detright >= T(0) ) { return det; }
+		detsum = -detleft - detright;
+	}
+	else {
+		return det;
+	}
+
+	T errbound = constants_t::orient2d_bound * detsum;
+	if( det >= errbound || -det >= errbound ) { return det; }
+
+	return detail::predicates::orient2d_exact( ax, ay, bx, by, cx, cy );
+}
+
+// same shape as orient2d, two products of rounded differences,
+//   so the same error bound applies
+template<typename T>
+inline T turn2d( T ax, T ay, T bx, T by, T cx, T cy, T dx, T dy ) {
+	typedef detail::predicates::constants<T> constants_t;
+
+	T detleft  = ( bx - ax ) * ( dy - cy );
+	T detright = ( by - ay ) * ( dx - cx );
+	T det = detleft - detright;
+
+	T detsum;
+	if( detleft > T(0) ) {
+		if( detright <= T(0) ) { return det; }
+		detsum = detleft + detright;
+	}
+	else if( detleft < T(0) ) {
+		if( detright >= T(0) ) { return det; }
+		detsum = -detleft - detright;
+	}
+	else {
+		return det;
+	}
+
+	T errbound = constants_t::orient2d_bound * detsum;
+	if( det >= errbound || -det >= errbound ) { return det; }
+
+	return detail::predicates::turn2d_exact( ax, ay, bx, by, cx, cy, dx, dy );
+}
+
+template<typename T>
+inline T orient3d( T ax, T ay, T az, T bx, T by, T bz,
+                   T cx, T cy, T cz, T dx, T dy, T dz ) {
+	typedef detail::predicates::constants<T> constants_t;
+	using std::abs;
+
+	T adx = ax - dx, ady = ay - dy, adz = az - dz;
+	T bdx = bx - dx, bdy = by - dy, bdz = bz - dz;
+	T cdx = cx - dx, cdy = cy - dy, cdz = cz - dz;
+
+	T bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+	T cdxady = cdx * ady, adxcdy = adx * cdy;
+	T adxbdy = adx * bdy, bdxady = bdx * ady;
+
+	T det = adz * ( bdxcdy - cdxbdy )
+	      + bdz * ( cdxady - adxcdy )
+	      + cdz * ( adxbdy - bdxady );
+
+	T permanent = ( abs( bdxcdy ) + abs( cdxbdy ) ) * abs( adz )
+	            + ( abs( cdxady ) + abs( adxcdy ) ) * abs( bdz )
+	            + ( abs( adxbdy ) + abs( bdxady ) ) * abs( cdz );
+	T errbound = constants_t::orient3d_bound * permanent;
+	if( det > errbound || -det > errbound ) { return det; }
+
+	return detail::predicates::orient3d_exact( ax, ay, az, bx, by, bz, cx, cy, cz, dx, dy, dz );
+}
+
+template<typename T>
+inline T incircle( T ax, T ay, T bx, T by, T cx, T cy, T dx, T dy ) {
+	typedef detail::predicates::constants<T> constants_t;
+	using std::abs;
+
+	T adx = ax - dx, ady = ay - dy;
+	T bdx = bx - dx, bdy = by - dy;
+	T cdx = cx - dx, cdy = cy - dy;
+
+	T bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+	T alift = adx * adx + ady * ady;
+	T cdxady = cdx * ady, adxcdy = adx * cdy;
+	T blift = bdx * bdx + bdy * bdy;
+	T adxbdy = adx * bdy, bdxady = bdx * ady;
+	T clift = cdx * cdx + cdy * cdy;
+
+	T det = alift * ( bdxcdy - cdxbdy )
+	      + blift * ( cdxady - adxcdy )
+	      + clift * ( adxbdy - bdxady );
+
+	T permanent = ( abs( bdxcdy ) + abs( cdxbdy ) ) * alift
+	            + ( abs( cdxady ) + abs( adxcdy ) ) * blift
+	            + ( abs( adxbdy ) + abs( bdxady ) ) * clift;
+	T errbound = constants_t::incircle_bound * permanent;
+	if( det > errbound || -det > errbound ) { return det; }
+
+	return detail::predicates::incircle_exact( ax, ay, bx, by, cx, cy, dx, dy );
+}
+
+
+////////////////////////////////////////
+// Predicates on points
+
+// Positive if a, b, c turn counterclockwise, negative if
+//   clockwise and zero if they are collinear
+template<typename T>
+inline T orient2d( const point2<T>& a, const point2<T>& b, const point2<T>& c ) {
+	return orient2d( a.x( ), a.y( ), b.x( ), b.y( ), c.x( ), c.y( ) );
+}
+
+// Positive if the direction c->d is counterclockwise from a->b, negative
+//   if clockwise and zero if they are parallel, the cross product of the two
+template<typename T>
+inline T turn2d( const point2<T>& a, const point2<T>& b,
+                 const point2<T>& c, const point2<T>& d ) {
+	return turn2d( a.x( ), a.y( ), b.x( ), b.y( ), c.x( ), c.y( ), d.x( ), d.y( ) );
+}
+
+// Positive if d is below the plane through a, b, c, taking a, b, c as
+//   counterclockwise seen from above, negative if above, zero if coplanar
+template<typename T>
+inline T orient3d( const point3<T>& a, const point3<T>& b,
+                   const point3<T>& c, const point3<T>& d ) {
+	return orient3d( a.x( ), a.y( ), a.z( ), b.x( ), b.y( ), b.z( ),
+	                 c.x( ), c.y( ), c.z( ), d.x( ), d.y( ), d.z( ) );
+}
+
+// Positive if d is inside the circle through a, b, c, which must be in
+//   counterclockwise order, negative if outside, zero if on the circle
+template<typename T>
+inline T incircle( const point2<T>& a, const point2<T>& b,
+                   const point2<T>& c, const point2<T>& d ) {
+	return incircle( a.x( ), a.y( ), b.x( ), b.y( ), c.x( ), c.y( ), d.x( ), d.y( ) );
+}
+
+}  // End namespace euclib
+
+#endif // EUBLIB_PREDICATES_HPP
@@ -21,6 +21,7 @@
 
 #include <ostream>
 #include <limits>
+#include <type_traits>
 #include "line.hpp"
 #include "point.hpp"
 
@@ -52,8 +53,8 @@ private:
 public:
 
 	rect2( ) { set_null( ); }
-	rect2( const rect2<T>& rect ) { *this = rect; }
-	rect2( rect2<T>&& rect ) { *this = std::move( rect ); }
+	rect2( const rect2<T>& rect ) = default;
+	rect2( rect2<T>&& rect ) = default;
 	rect2( T left, T right, T top, T bottom ) :
 		l( left ),
 		r( right ),
@@ -62,10 +63,10 @@ public:
 		check_valid( );
 	}
 	rect2( const point2<T>& location, T width, T height ) :
-		l( location.x ),
-		r( location.x + width ),
-		t( location.y ),
-		b( location.y + height ) {
+		l( location.x( ) ),
+		r( location.x( ) + width ),
+		t( location.y( ) ),
+		b( location.y( ) + height ) {
 		check_valid( );
 	}
 
@@ -117,24 +118,9 @@ private:
 // Operators
 public:
 
-	rect2<T>& operator = ( const rect2<T>& rect ) {
-		l = rect.l;
-		r = rect.r;
-		t = rect.t;
-		b = rect.b;
-		check_valid( );
-		return *this;
-	}
-
-	rect2<T>& operator = ( rect2<T>&& rect ) {
-		l = rect.l;
-		r = rect.r;
-		t = rect.t;
-		b = rect.b;
-		rect.l = rect.r = rect.t = rect.b = 0; // rect will be deleted
-		check_valid( );
-		return *this;
-	}
+	// plain copies, a rect is validated when it is constructed
+	rect2<T>& operator = ( const rect2<T>& rect ) = default;
+	rect2<T>& operator = ( rect2<T>&& rect ) = default;
 
 	bool operator == ( const rect2<T>& rect ) const {
 		if( l == rect.l && r == rect.r && t == rect.t && b == rect.b ) {
@@ -186,6 +172,18 @@ public:
 typedef rect2<int>           rect2i;
 typedef rect2<float>         rect2f;
 typedef rect2<unsigned int>  rect2u;
+typedef rect2<double>        rect2d;
+
+
+static_assert( std::is_trivially_copyable<rect2f>::value &&
+               std::is_trivially_copyable<rect2d>::value,
+               "rect2 must be trivially copyable" );
+static_assert( std::is_standard_layout<rect2f>::value &&
+               std::is_standard_layout<rect2d>::value,
+               "rect2 must be standard layout" );
+static_assert( sizeof(rect2f) == 4*sizeof(float) &&
+               sizeof(rect2d) == 4*sizeof(double),
+               "rect2 must be exactly the size of its edges" );
 
 // Initialize invalid with either infinity or max
 template<typename T>
@@ -168,6 +168,19 @@ public:
 typedef segment<float,2>         segment2f;
 typedef segment<double,2>        segment2d;
 
+template<typename T> using segment2 = segment<T,2>;
+
+
+static_assert( std::is_trivially_copyable<segment2f>::value &&
+               std::is_trivially_copyable<segment<double,3>>::value,
+               "segment must be trivially copyable" );
+static_assert( std::is_standard_layout<segment2f>::value &&
+               std::is_standard_layout<segment<double,3>>::value,
+               "segment must be standard layout" );
+static_assert( sizeof(segment2f) == 2*2*sizeof(float) &&
+               sizeof(segment<double,3>) == 2*3*sizeof(double),
+               "segment must be exactly the size of its point and vector" );
+
 }  // End namespace euclib
 
 #endif // EUBLIB_SEGMENT_HPP
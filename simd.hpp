@@ -0,0 +1,176 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_SIMD_HPP
+#define EUBLIB_SIMD_HPP
+
+#include <cstddef>	// for std::size_t
+#include <cmath>
+#include <type_traits>
+#include <utility>	// for std::index_sequence
+
+/*
+ * Fixed-size kernels used by point_base and vector
+ *
+ *   The kernels are unrolled at compile time and usable in constant
+ *   expressions.  A single point is left to the compiler, which already
+ *   vectorizes loops over points better than one register per point can
+ *   (see bench.cpp).
+ *
+ *   packet<T> is the register type used by the batch code that works on
+ *   many points at a time (vector.hpp, polygon.hpp, hull.hpp), built on
+ *   SSE2 intrinsics when the compiler targets it unless EUCLIB_NO_SIMD
+ *   is defined.
+ */
+
+#if !defined(EUCLIB_NO_SIMD) && ( defined(__SSE2__) || defined(_M_X64) )
+#	define EUCLIB_SIMD_SSE2
+#	include <emmintrin.h>
+#endif
+
+namespace euclib { namespace simd {
+
+////////////////////////////////////////
+// Register wide packets of T
+//   the primary template is a single value so that it
+//   can stand in when no vector unit is available
+
+template<typename T>
+struct packet {
+	typedef T type;
+	enum { size = 1 };
+
+	static type load( const T* p )             { return *p; }
+	static type loadu( const T* p )            { return *p; }
+	static void store( T* p, type a )          { *p = a; }
+	static void storeu( T* p, type a )         { *p = a; }
+	static type set1( T value )                { return value; }
+	static type add( type a, type b )          { return a + b; }
+	static type sub( type a, type b )          { return a - b; }
+	static type mul( type a, type b )          { return a * b; }
+	static type div( type a, type b )          { return a / b; }
+
+	static type sqrt( type a )                 { using std::sqrt; return sqrt( a ); }
+	static type rsqrt( type a )                { return T(1) / sqrt( a ); }
+
+	static type abs( type a )                  { return a < T(0) ? -a : a; }
+	static bool all_greater( type a, type b )  { return a > b; }
+
+	// rows[k] lane j becomes rows[j] lane k
+	static void transpose( type* ) { }
+};
+
+#ifdef EUCLIB_SIMD_SSE2
+
+template< >
+struct packet<float> {
+	typedef __m128 type;
+	enum { size = 4 };
+
+	static type load( const float* p )         { return _mm_load_ps( p ); }
+	static type loadu( const float* p )        { return _mm_loadu_ps( p ); }
+	static void store( float* p, type a ) {
+	#ifdef __GNUC__
+		// _mm_store_ps may alias anything, so callers would reload every
+		//   pointer after each store; a plain vector type only aliases float
+		typedef float store_t __attribute__(( vector_size(16) ));
+		*reinterpret_cast<store_t*>( p ) = (store_t)a;
+	#else
+		_mm_store_ps( p, a );
+	#endif
+	}
+	static void storeu( float* p, type a )     { _mm_storeu_ps( p, a ); }
+	static type set1( float value )            { return _mm_set1_ps( value ); }
+	static type add( type a, type b )          { return _mm_add_ps( a, b ); }
+	static type sub( type a, type b )          { return _mm_sub_ps( a, b ); }
+	static type mul( type a, type b )          { return _mm_mul_ps( a, b ); }
+	static type div( type a, type b )          { return _mm_div_ps( a, b ); }
+
+	static type sqrt( type a )                 { return _mm_sqrt_ps( a ); }
+	static type rsqrt( type a )                { return _mm_div_ps( _mm_set1_ps( 1.f ), _mm_sqrt_ps( a ) ); }
+
+	static type abs( type a )                  { return _mm_andnot_ps( _mm_set1_ps( -0.f ), a ); }
+	static bool all_greater( type a, type b )  { return _mm_movemask_ps( _mm_cmpgt_ps( a, b ) ) == 0xF; }
+
+	static void transpose( type* rows ) { _MM_TRANSPOSE4_PS( rows[0], rows[1], rows[2], rows[3] ); }
+};
+
+template< >
+struct packet<double> {
+	typedef __m128d type;
+	enum { size = 2 };
+
+	static type load( const double* p )        { return _mm_load_pd( p ); }
+	static type loadu( const double* p )       { return _mm_loadu_pd( p ); }
+	static void store( double* p, type a ) {
+	#ifdef __GNUC__
+		typedef double store_t __attribute__(( vector_size(16) ));
+		*reinterpret_cast<store_t*>( p ) = (store_t)a;
+	#else
+		_mm_store_pd( p, a );
+	#endif
+	}
+	static void storeu( double* p, type a )    { _mm_storeu_pd( p, a ); }
+	static type set1( double value )           { return _mm_set1_pd( value ); }
+	static type add( type a, type b )          { return _mm_add_pd( a, b ); }
+	static type sub( type a, type b )          { return _mm_sub_pd( a, b ); }
+	static type mul( type a, type b )          { return _mm_mul_pd( a, b ); }
+	static type div( type a, type b )          { return _mm_div_pd( a, b ); }
+
+	static type sqrt( type a )                 { return _mm_sqrt_pd( a ); }
+	static type rsqrt( type a )                { return _mm_div_pd( _mm_set1_pd( 1.0 ), _mm_sqrt_pd( a ) ); }
+
+	static type abs( type a )                  { return _mm_andnot_pd( _mm_set1_pd( -0.0 ), a ); }
+	static bool all_greater( type a, type b )  { return _mm_movemask_pd( _mm_cmpgt_pd( a, b ) ) == 0x3; }
+
+	static void transpose( type* rows ) {
+		type lo = _mm_unpacklo_pd( rows[0], rows[1] );
+		rows[1] = _mm_unpackhi_pd( rows[0], rows[1] );
+		rows[0] = lo;
+	}
+};
+
+#endif // EUCLIB_SIMD_SSE2
+
+
+////////////////////////////////////////
+// Kernels over D contiguous values of T
+//   unrolled with index sequences, so any D gets the
+//   same straight-line code as a hand written version
+
+template<typename T, std::size_t D, typename I = std::make_index_sequence<D>>
+struct unrolled;
+
+template<typename T, std::size_t D, std::size_t... I>
+struct unrolled<T,D,std::index_sequence<I...>> {
+	static constexpr void add( T* lhs, const T* rhs ) { ( ( lhs[I] += rhs[I] ), ... ); }
+	static constexpr void sub( T* lhs, const T* rhs ) { ( ( lhs[I] -= rhs[I] ), ... ); }
+	static constexpr void mul( T* lhs, T scalar )     { ( ( lhs[I] *= scalar ), ... ); }
+	static constexpr void div( T* lhs, T scalar )     { ( ( lhs[I] /= scalar ), ... ); }
+
+	static constexpr T dot( const T* lhs, const T* rhs ) {
+		return ( ... + ( lhs[I] * rhs[I] ) );
+	}
+};
+
+template<typename T, std::size_t D>
+struct kernel : unrolled<T,D> { };
+
+} } // End namespace euclib::simd
+
+#endif // EUBLIB_SIMD_HPP
@@ -0,0 +1,525 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_SIMPLE_POLYGON_HPP
+#define EUBLIB_SIMPLE_POLYGON_HPP
+
+#include <cstddef>	// for std::size_t
+#include <limits>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <type_traits>
+#include <cassert>
+
+#include "point.hpp"
+#include "rect.hpp"
+#include "predicates.hpp"
+
+/*
+ * Polygon that keeps its vertices as given, with any number of holes
+ *
+ *   Unlike polygon2, which only keeps the convex hull of what it is given,
+ *   the vertices here are the boundary itself: an outer ring followed by the
+ *   rings of its holes, stored back to back.  Rings may run either way round.
+ *   The boundary must be simple, no ring crosses itself or another.
+ *
+ *   triangulate( ) writes the triangles as triples of indices into that
+ *   storage.  It is O(n log n): a sweep from top to bottom adds diagonals at
+ *   the vertices where the boundary turns back on itself, which cuts the
+ *   polygon into y-monotone pieces, and each piece is then triangulated in
+ *   linear time (de Berg et al., Computational Geometry, chapter 3).
+ */
+
+namespace euclib {
+
+namespace detail { namespace triangulation {
+
+	// The sweep order, top to bottom, then left to right
+	//   (as if the plane were turned a hair clockwise)
+	template<typename T>
+	inline bool above( const point2<T>& a, const point2<T>& b ) {
+		return a.y( ) > b.y( ) || ( a.y( ) == b.y( ) && a.x( ) < b.x( ) );
+	}
+
+	template<typename T>
+	inline bool same( const point2<T>& a, const point2<T>& b ) {
+		return a.x( ) == b.x( ) && a.y( ) == b.y( );
+	}
+
+	// regular vertices are named for the side the interior is on
+	enum class vertex_type { start, split, end, merge, regular_left, regular_right };
+
+	template<typename T>
+	class triangulator {
+		typedef std::size_t size_t;
+		static constexpr size_t none = size_t(-1);
+
+		const point2<T>*    m_pt;
+		std::vector<size_t> m_next;   // neighbours along the boundary,
+		std::vector<size_t> m_prev;   //   with the interior on the left
+
+		// Half-edges, the first n are the boundary edges v -> m_next[v],
+		//   diagonals are added in pairs after them
+		std::vector<size_t> m_origin;
+		std::vector<size_t> m_hnext;
+		std::vector<size_t> m_hprev;
+		std::vector<size_t> m_around;      // next diagonal leaving the same vertex
+		std::vector<size_t> m_first_diag;  // per vertex
+
+		// Sweep status, the boundary edges crossing the sweep line with the
+		//   interior on their right, ordered west to east; an edge is named
+		//   by the vertex it leaves, which is its upper end
+		struct vertex_key { size_t v; };
+
+		struct edge_less {
+			typedef void is_transparent;
+			const triangulator* t;
+
+			// positive if p is west of the edge
+			T side( size_t e, const point2<T>& p ) const {
+				return orient2d( t->m_pt[t->m_next[e]], t->m_pt[e], p );
+			}
+
+			bool operator () ( size_t a, size_t b ) const {
+				if( a == b ) { return false; }
+				const point2<T>& au = t->m_pt[a];
+				const point2<T>& bu = t->m_pt[b];
+				if( !above( au, bu ) ) {
+					T s = side( b, au );
+					if( s == T(0) ) { s = side( b, t->m_pt[t->m_next[a]] ); }
+					return s > T(0);
+				}
+				T s = side( a, bu );
+				if( s == T(0) ) { s = side( a, t->m_pt[t->m_next[b]] ); }
+				return s < T(0);
+			}
+
+			bool operator () ( size_t e, vertex_key k ) const { return side( e, t->m_pt[k.v] ) < T(0); }
+			bool operator () ( vertex_key k, size_t e ) const { return side( e, t->m_pt[k.v] ) > T(0); }
+		};
+
+		typedef std::set<size_t, edge_less> status_t;
+
+	public:
+
+		// rings holds the start of every ring and the end of the last,
+		//   the first ring is the outside
+		triangulator( const point2<T>* pt, const std::vector<size_t>& rings ) : m_pt( pt ) {
+			const size_t n = rings.back( );
+			m_next.assign( n, none );
+			m_prev.assign( n, none );
+			std::vector<size_t> ring;
+			for( size_t r = 0; r + 1 < rings.size( ); ++r ) {
+				// repeated vertices are passed over
+				ring.clear( );
+				for( size_t i = rings[r]; i < rings[r+1]; ++i ) {
+					if( ring.empty( ) || !same( pt[i], pt[ring.back( )] ) ) { ring.push_back( i ); }
+				}
+				while( ring.size( ) > 1 && same( pt[ring.back( )], pt[ring.front( )] ) ) { ring.pop_back( ); }
+				const size_t k = ring.size( );
+				if( k < 3 ) { continue; }
+
+				// the outside runs counterclockwise and the holes clockwise
+				typename std::conditional<std::is_same<T,float>::value, double, T>::type area = 0;
+				for( size_t i = 0, j = k - 1; i < k; j = i++ ) {
+					area += ( pt[ring[j]].x( ) - pt[ring[i]].x( ) ) * ( pt[ring[j]].y( ) + pt[ring[i]].y( ) );
+				}
+				const bool forward = ( r == 0 ) == ( area > 0 );
+				for( size_t i = 0; i < k; ++i ) {
+					const size_t after  = ring[( i + 1 == k ) ? 0 : i + 1];
+					const size_t before = ring[( i == 0 ) ? k - 1 : i - 1];
+					m_next[ring[i]] = forward ? after : before;
+					m_prev[ring[i]] = forward ? before : after;
+				}
+			}
+
+			m_origin.resize( n );
+			m_hnext = m_next;
+			m_hprev = m_prev;
+			m_around.assign( n, none );
+			m_first_diag.assign( n, none );
+			for( size_t v = 0; v < n; ++v ) { m_origin[v] = v; }
+		}
+
+		template<typename Emit>
+		void run( Emit emit ) {
+			partition( );
+
+			// every face is now y-monotone
+			std::vector<bool>   visited( m_origin.size( ), false );
+			std::vector<size_t> face;
+			for( size_t h = 0; h < m_origin.size( ); ++h ) {
+				if( visited[h] || m_hnext[h] == none ) { continue; }
+				face.clear( );
+				for( size_t e = h; !visited[e]; e = m_hnext[e] ) {
+					visited[e] = true;
+					face.push_back( m_origin[e] );
+				}
+				triangulate_monotone( face, emit );
+			}
+		}
+
+	private:
+
+		bool in_wedge( size_t p, size_t a, size_t n, size_t b ) const {
+			// the interior runs counterclockwise from a->n round to a->p
+			if( orient2d( m_pt[p], m_pt[a], m_pt[n] ) > T(0) ) {
+				return orient2d( m_pt[a], m_pt[n], m_pt[b] ) > T(0) &&
+				       orient2d( m_pt[a], m_pt[p], m_pt[b] ) < T(0);
+			}
+			return !( orient2d( m_pt[a], m_pt[n], m_pt[b] ) <= T(0) &&
+			          orient2d( m_pt[a], m_pt[p], m_pt[b] ) >= T(0) );
+		}
+
+		// the half-edge leaving a on the face the diagonal to b runs through
+		size_t leaving_towards( size_t a, size_t b ) const {
+			for( size_t h = a; h != none; h = ( h == a ) ? m_first_diag[a] : m_around[h] ) {
+				if( in_wedge( m_origin[m_hprev[h]], a, m_origin[m_hnext[h]], b ) ) { return h; }
+			}
+			assert( false && "boundary is not simple" );
+			return a;
+		}
+
+		void add_diagonal( size_t a, size_t b ) {
+			const size_t ha = leaving_towards( a, b );
+			const size_t hb = leaving_towards( b, a );
+			const size_t pa = m_hprev[ha];
+			const size_t pb = m_hprev[hb];
+
+			const size_t d1 = m_origin.size( );  // a -> b
+			const size_t d2 = d1 + 1;            // b -> a
+			m_origin.push_back( a );
+			m_origin.push_back( b );
+			m_hnext.push_back( hb );
+			m_hnext.push_back( ha );
+			m_hprev.push_back( pa );
+			m_hprev.push_back( pb );
+			m_around.push_back( m_first_diag[a] );
+			m_around.push_back( m_first_diag[b] );
+			m_first_diag[a] = d1;
+			m_first_diag[b] = d2;
+
+			m_hnext[pa] = d1;
+			m_hprev[hb] = d1;
+			m_hnext[pb] = d2;
+			m_hprev[ha] = d2;
+		}
+
+		vertex_type classify( size_t v ) const {
+			const point2<T>& p = m_pt[m_prev[v]];
+			const point2<T>& n = m_pt[m_next[v]];
+			const bool p_below = above( m_pt[v], p );
+			const bool n_below = above( m_pt[v], n );
+			const bool convex = orient2d( p, m_pt[v], n ) > T(0);
+			if( p_below && n_below )   { return convex ? vertex_type::start : vertex_type::split; }
+			if( !p_below && !n_below ) { return convex ? vertex_type::end : vertex_type::merge; }
+			return p_below ? vertex_type::regular_left : vertex_type::regular_right;
+		}
+
+		void partition( ) {
+			const size_t n = m_next.size( );
+			std::vector<size_t> order;
+			order.reserve( n );
+			for( size_t v = 0; v < n; ++v ) {
+				if( m_next[v] != none ) { order.push_back( v ); }
+			}
+			std::sort( order.begin( ), order.end( ), [this]( size_t a, size_t b ) {
+				return above( m_pt[a], m_pt[b] ) || ( !above( m_pt[b], m_pt[a] ) && a < b );
+			} );
+
+			std::vector<vertex_type> type( n );
+			for( size_t v : order ) { type[v] = classify( v ); }
+
+			status_t status( edge_less{ this } );
+			std::vector<typename status_t::iterator> where( n );
+			std::vector<size_t> helper( n, none );
+
+			auto insert = [&]( size_t v ) {
+				where[v] = status.insert( v ).first;
+				helper[v] = v;
+			};
+			// closes the edge ending at v, connecting a merge vertex left above it
+			auto close = [&]( size_t v ) {
+				const size_t e = m_prev[v];
+				if( type[helper[e]] == vertex_type::merge ) { add_diagonal( v, helper[e] ); }
+				status.erase( where[e] );
+			};
+			auto left_of = [&]( size_t v ) {
+				auto itr = status.lower_bound( vertex_key{ v } );
+				assert( itr != status.begin( ) );
+				return *--itr;
+			};
+
+			for( size_t v : order ) {
+				switch( type[v] ) {
+					case vertex_type::start:
+						insert( v );
+						break;
+
+					case vertex_type::end:
+						close( v );
+						break;
+
+					case vertex_type::split: {
+						const size_t e = left_of( v );
+						add_diagonal( v, helper[e] );
+						helper[e] = v;
+						insert( v );
+						break;
+					}
+
+					case vertex_type::merge: {
+						close( v );
+						const size_t e = left_of( v );
+						if( type[helper[e]] == vertex_type::merge ) { add_diagonal( v, helper[e] ); }
+						helper[e] = v;
+						break;
+					}
+
+					case vertex_type::regular_right:
+						close( v );
+						insert( v );
+						break;
+
+					case vertex_type::regular_left: {
+						const size_t e = left_of( v );
+						if( type[helper[e]] == vertex_type::merge ) { add_diagonal( v, helper[e] ); }
+						helper[e] = v;
+						break;
+					}
+				}
+			}
+		}
+
+		template<typename Emit>
+		void triangle( size_t a, size_t b, size_t c, Emit& emit ) const {
+			if( orient2d( m_pt[a], m_pt[b], m_pt[c] ) < T(0) ) { std::swap( b, c ); }
+			emit( a, b, c );
+		}
+
+		// A y-monotone face, counterclockwise, with the stack walk over its
+		//   vertices in sweep order
+		template<typename Emit>
+		void triangulate_monotone( const std::vector<size_t>& face, Emit& emit ) {
+			const size_t k = face.size( );
+			if( k < 3 ) { return; }
+			if( k == 3 ) {
+				triangle( face[0], face[1], face[2], emit );
+				return;
+			}
+
+			size_t top = 0, bottom = 0;
+			for( size_t i = 1; i < k; ++i ) {
+				if( above( m_pt[face[i]], m_pt[face[top]] ) )    { top = i; }
+				if( above( m_pt[face[bottom]], m_pt[face[i]] ) ) { bottom = i; }
+			}
+
+			// counterclockwise from the top runs down the left chain,
+			//   clockwise runs down the right, merge the two
+			m_sorted.clear( );
+			size_t l = top, r = ( top == 0 ) ? k - 1 : top - 1;
+			m_sorted.push_back( { face[top], true } );
+			l = ( l + 1 == k ) ? 0 : l + 1;
+			while( m_sorted.size( ) < k ) {
+				const bool left_done  = ( l == ( bottom + 1 ) % k );
+				const bool right_done = ( r == bottom );
+				if( !left_done && ( right_done || above( m_pt[face[l]], m_pt[face[r]] ) ) ) {
+					m_sorted.push_back( { face[l], true } );
+					l = ( l + 1 == k ) ? 0 : l + 1;
+				}
+				else {
+					m_sorted.push_back( { face[r], false } );
+					r = ( r == 0 ) ? k - 1 : r - 1;
+				}
+			}
+
+			m_stack.clear( );
+			m_stack.push_back( m_sorted[0] );
+			m_stack.push_back( m_sorted[1] );
+			for( size_t j = 2; j + 1 < k; ++j ) {
+				const chain_vertex u = m_sorted[j];
+				if( u.left != m_stack.back( ).left ) {
+					// fan out to the whole stack, it is the other chain
+					for( size_t i = 0; i + 1 < m_stack.size( ); ++i ) {
+						triangle( u.v, m_stack[i].v, m_stack[i+1].v, emit );
+					}
+					m_stack.clear( );
+					m_stack.push_back( m_sorted[j-1] );
+					m_stack.push_back( u );
+				}
+				else {
+					// cut off the corners of the same chain while they are convex
+					chain_vertex last = m_stack.back( );
+					m_stack.pop_back( );
+					while( !m_stack.empty( ) ) {
+						const size_t s = m_stack.back( ).v;
+						const T turn = u.left ? orient2d( m_pt[s], m_pt[last.v], m_pt[u.v] )
+						                      : orient2d( m_pt[u.v], m_pt[last.v], m_pt[s] );
+						if( turn <= T(0) ) { break; }
+						triangle( u.v, last.v, s, emit );
+						last = m_stack.back( );
+						m_stack.pop_back( );
+					}
+					m_stack.push_back( last );
+					m_stack.push_back( u );
+				}
+			}
+
+			const size_t u = m_sorted[k-1].v;
+			for( size_t i = 0; i + 1 < m_stack.size( ); ++i ) {
+				triangle( u, m_stack[i].v, m_stack[i+1].v, emit );
+			}
+		}
+
+		struct chain_vertex {
+			size_t v;
+			bool   left;
+		};
+
+		// scratch for triangulate_monotone( ), kept between faces
+		std::vector<chain_vertex> m_sorted;
+		std::vector<chain_vertex> m_stack;
+	};
+
+} } // End namespace detail::triangulation
+
+
+template<typename T>
+class simple_polygon2 {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	static_assert( std::is_floating_point<T>::value,
+	               "T must be floating point" );
+
+	typedef typename std::conditional<std::is_same<T,float>::value,
+	                                  double, T>::type accum_t;
+
+
+// Variables
+private:
+
+	std::vector<point2<T>>   m_points;  // the outer ring, then each hole
+	std::vector<std::size_t> m_rings;   // ring r is [ m_rings[r], m_rings[r+1] )
+
+
+// Constructors
+public:
+
+	simple_polygon2( ) : m_rings( 2, 0 ) { }
+	simple_polygon2( const std::vector<point2<T>>& outer ) :
+		m_points( outer ),
+		m_rings{ 0, outer.size( ) } {
+	}
+	template<typename InputIt>
+	simple_polygon2( InputIt first, InputIt last ) :
+		m_points( first, last ),
+		m_rings{ 0, m_points.size( ) } {
+	}
+
+
+// Methods
+public:
+
+	template<typename InputIt>
+	void add_hole( InputIt first, InputIt last ) {
+		m_points.insert( m_points.end( ), first, last );
+		m_rings.push_back( m_points.size( ) );
+	}
+	void add_hole( const std::vector<point2<T>>& hole ) { add_hole( hole.begin( ), hole.end( ) ); }
+
+	// every vertex, the outer ring first and then each hole
+	const std::vector<point2<T>>& vertices( ) const { return m_points; }
+	std::size_t size( ) const { return m_points.size( ); }
+	std::size_t holes( ) const { return m_rings.size( ) - 2; }
+
+	// ring 0 is the outside, 1 to holes( ) the holes
+	const point2<T>* ring( std::size_t r ) const { return m_points.data( ) + m_rings[r]; }
+	std::size_t ring_size( std::size_t r ) const { return m_rings[r+1] - m_rings[r]; }
+
+	T area( ) const {
+		accum_t result = 0;
+		for( std::size_t r = 0; r + 1 < m_rings.size( ); ++r ) {
+			accum_t ring_area = 0;
+			for( std::size_t i = m_rings[r], j = m_rings[r+1] - 1; i < m_rings[r+1]; j = i++ ) {
+				ring_area += accum_t( m_points[j].x( ) ) * m_points[i].y( ) -
+				             accum_t( m_points[i].x( ) ) * m_points[j].y( );
+			}
+			ring_area = ring_area < 0 ? -ring_area : ring_area;
+			result += ( r == 0 ) ? ring_area : -ring_area;
+		}
+		return static_cast<T>( result / 2 );
+	}
+
+	rect2<T> bounding_box( ) const {
+		if( m_points.empty( ) ) { return rect2<T>::null( ); }
+		T l = m_points[0].x( ), r = l, t = m_points[0].y( ), b = t;
+		for( auto itr = m_points.begin( ) + 1; itr != m_points.end( ); ++itr ) {
+			l = std::min( l, itr->x( ) );
+			r = std::max( r, itr->x( ) );
+			t = std::min( t, itr->y( ) );
+			b = std::max( b, itr->y( ) );
+		}
+		return rect2<T>( l, r, t, b );
+	}
+
+	// Even-odd rule over every ring, O(n)
+	//   points on the boundary may go either way
+	bool contains( const point2<T>& pt ) const {
+		bool inside = false;
+		for( std::size_t r = 0; r + 1 < m_rings.size( ); ++r ) {
+			for( std::size_t i = m_rings[r], j = m_rings[r+1] - 1; i < m_rings[r+1]; j = i++ ) {
+				const point2<T>& a = m_points[j];
+				const point2<T>& b = m_points[i];
+				if( ( a.y( ) > pt.y( ) ) != ( b.y( ) > pt.y( ) ) ) {
+					const T side = orient2d( a, b, pt );
+					if( b.y( ) > a.y( ) ? side > T(0) : side < T(0) ) { inside = !inside; }
+				}
+			}
+		}
+		return inside;
+	}
+
+	// Appends three indices into vertices( ) per triangle, counterclockwise,
+	//   size( ) + 2 * holes( ) - 2 triangles in all; returns how many
+	template<typename Index>
+	std::size_t triangulate( std::vector<Index>& indices ) const {
+		const std::size_t before = indices.size( );
+		indices.reserve( before + 3 * ( size( ) + 2 * holes( ) ) );
+		detail::triangulation::triangulator<T> tri( m_points.data( ), m_rings );
+		tri.run( [&indices]( std::size_t a, std::size_t b, std::size_t c ) {
+			indices.push_back( static_cast<Index>( a ) );
+			indices.push_back( static_cast<Index>( b ) );
+			indices.push_back( static_cast<Index>( c ) );
+		} );
+		return ( indices.size( ) - before ) / 3;
+	}
+
+}; // End class simple_polygon2<T>
+
+
+// Various typedefs to make usage easier
+typedef simple_polygon2<float>    simple_polygon2f;
+typedef simple_polygon2<double>   simple_polygon2d;
+
+}  // End namespace euclib
+
+#endif // EUBLIB_SIMPLE_POLYGON_HPP
@@ -0,0 +1,392 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_SIMPLIFY_HPP
+#define EUBLIB_SIMPLIFY_HPP
+
+#include <cstddef>	// for std::size_t
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <type_traits>
+
+#include "point.hpp"
+
+/*
+ * Polyline simplification
+ *
+ *   douglas_peucker( ) keeps every point needed so that no dropped point is
+ *   further than the tolerance from the simplified line.  The ranges still
+ *   to be split are kept on a stack, left half on top, so points come out
+ *   in order as the ranges are finished and the only memory is the stack.
+ *
+ *   visvalingam_whyatt( ) repeatedly drops the point that spans the
+ *   smallest triangle with its neighbours, until every triangle left is at
+ *   least the given area.  The candidates are kept in a heap; when a point
+ *   goes its neighbours move in the heap to their new areas.
+ *
+ *   visvalingam_stream does the same over a window of a fixed number of
+ *   points, for tracks too long to hold.  Once the window fills it is
+ *   simplified and the front half is written out for good, the back half
+ *   stays to be simplified against what comes next.
+ *
+ *   All of them work on point<T,D> for any D, and the first and last
+ *   points are always kept.
+ */
+
+namespace euclib {
+
+namespace detail { namespace simplify {
+
+	template<typename T>
+	struct accumulator {
+		typedef typename std::conditional<std::is_same<T,float>::value,
+		                                  double, T>::type type;
+	};
+
+	// Squared distance from p to the segment a-b
+	template<typename T, std::size_t D>
+	inline typename accumulator<T>::type
+	distance_sq( const point<T,D>& p, const point<T,D>& a, const point<T,D>& b ) {
+		typedef typename accumulator<T>::type accum_t;
+		accum_t ab[D], ap[D];
+		accum_t ab_ab = 0, ap_ab = 0;
+		for( std::size_t i = 0; i < D; ++i ) {
+			ab[i] = accum_t( b[i] ) - a[i];
+			ap[i] = accum_t( p[i] ) - a[i];
+			ab_ab += ab[i] * ab[i];
+			ap_ab += ap[i] * ab[i];
+		}
+		accum_t t = 0;
+		if( ab_ab > 0 ) { t = std::min( std::max( ap_ab / ab_ab, accum_t(0) ), accum_t(1) ); }
+		accum_t result = 0;
+		for( std::size_t i = 0; i < D; ++i ) {
+			const accum_t d = ap[i] - t * ab[i];
+			result += d * d;
+		}
+		return result;
+	}
+
+	// Four times the squared area of the triangle a b c
+	//   |ab|^2 |ac|^2 - (ab.ac)^2, which holds in any dimension
+	template<typename T, std::size_t D>
+	inline typename accumulator<T>::type
+	area_key( const point<T,D>& a, const point<T,D>& b, const point<T,D>& c ) {
+		typedef typename accumulator<T>::type accum_t;
+		accum_t ab_ab = 0, ac_ac = 0, ab_ac = 0;
+		for( std::size_t i = 0; i < D; ++i ) {
+			const accum_t ab = accum_t( b[i] ) - a[i];
+			const accum_t ac = accum_t( c[i] ) - a[i];
+			ab_ab += ab * ab;
+			ac_ac += ac * ac;
+			ab_ac += ab * ac;
+		}
+		const accum_t result = ab_ab * ac_ac - ab_ac * ab_ac;
+		return result > 0 ? result : 0;
+	}
+
+	// The state of one run of Visvalingam-Whyatt, kept between runs
+	//   so that a stream reuses its memory
+	//
+	//   The heap holds each remaining point once and where[] follows it
+	//   around, so a neighbour's new area moves its entry rather than
+	//   adding another.  It is 4-ary: a long track gives a heap far larger
+	//   than the cache, and four children to a line halves the misses on
+	//   the way down.
+	template<typename T>
+	struct workspace {
+		typedef typename accumulator<T>::type accum_t;
+		typedef std::pair<accum_t,std::size_t> entry_t;
+
+		static constexpr std::size_t none = std::size_t(-1);
+
+		std::vector<std::size_t> prev;
+		std::vector<std::size_t> next;
+		std::vector<std::size_t> where;  // place in heap, none once out
+		std::vector<entry_t>     heap;   // smallest area on top
+
+		void place( std::size_t i, const entry_t& e ) {
+			heap[i] = e;
+			where[e.second] = i;
+		}
+
+		void sift_up( std::size_t i ) {
+			const entry_t e = heap[i];
+			while( i > 0 ) {
+				const std::size_t parent = ( i - 1 ) / 4;
+				if( !( e.first < heap[parent].first ) ) { break; }
+				place( i, heap[parent] );
+				i = parent;
+			}
+			place( i, e );
+		}
+
+		void sift_down( std::size_t i ) {
+			const std::size_t size = heap.size( );
+			const entry_t e = heap[i];
+			for( ;; ) {
+				const std::size_t first = 4 * i + 1;
+				if( first >= size ) { break; }
+				const std::size_t last = std::min( first + 4, size );
+				std::size_t best = first;
+				for( std::size_t c = first + 1; c < last; ++c ) {
+					if( heap[c].first < heap[best].first ) { best = c; }
+				}
+				if( !( heap[best].first < e.first ) ) { break; }
+				place( i, heap[best] );
+				i = best;
+			}
+			place( i, e );
+		}
+
+		void remove( std::size_t i ) {
+			const std::size_t at = where[i];
+			where[i] = none;
+			const entry_t last = heap.back( );
+			heap.pop_back( );
+			if( at == heap.size( ) ) { return; }
+			heap[at] = last;
+			sift_up( at );
+			sift_down( where[last.second] );
+		}
+
+		// point i has a new area, which may take it out of the running
+		void update( std::size_t i, accum_t area, accum_t limit ) {
+			if( where[i] == none ) {
+				if( area < limit ) {
+					heap.emplace_back( area, i );
+					sift_up( heap.size( ) - 1 );
+				}
+				return;
+			}
+			if( !( area < limit ) ) { return remove( i ); }
+			const std::size_t at = where[i];
+			const accum_t old = heap[at].first;
+			heap[at].first = area;
+			if( area < old ) { sift_up( at ); } else { sift_down( at ); }
+		}
+
+		// Drops points of pts[0, n) until no triangle is under limit
+		//   afterwards next[] links the survivors from 0 to n - 1
+		template<std::size_t D>
+		void run( const point<T,D>* pts, std::size_t n, accum_t limit ) {
+			prev.resize( n );
+			next.resize( n );
+			where.assign( n, none );
+			heap.clear( );
+			for( std::size_t i = 0; i < n; ++i ) {
+				prev[i] = i - 1;
+				next[i] = i + 1;
+			}
+			if( n == 0 ) { return; }
+			prev[0] = none;
+			next[n-1] = none;
+
+			for( std::size_t i = 1; i + 1 < n; ++i ) {
+				const accum_t area = area_key( pts[i-1], pts[i], pts[i+1] );
+				if( area < limit ) {
+					where[i] = heap.size( );
+					heap.emplace_back( area, i );
+				}
+			}
+			for( std::size_t i = heap.size( ) / 4 + 1; i-- > 0; ) {
+				if( i < heap.size( ) ) { sift_down( i ); }
+			}
+
+			while( !heap.empty( ) ) {
+				const std::size_t i = heap[0].second;
+				remove( i );
+
+				const std::size_t p = prev[i], q = next[i];
+				next[p] = q;
+				prev[q] = p;
+				if( p != 0 )     { update( p, area_key( pts[prev[p]], pts[p], pts[q] ), limit ); }
+				if( q != n - 1 ) { update( q, area_key( pts[p], pts[q], pts[next[q]] ), limit ); }
+			}
+		}
+	};
+
+} } // End namespace detail::simplify
+
+
+////////////////////////////////////////
+// Douglas-Peucker
+//   writes the kept points of [ first, last ) to out, in order
+
+template<typename RandomIt, typename T, typename OutputIt>
+OutputIt douglas_peucker( RandomIt first, RandomIt last, T tolerance, OutputIt out ) {
+	typedef typename detail::simplify::accumulator<T>::type accum_t;
+	typedef std::pair<std::size_t,std::size_t> range_t;
+
+	const std::size_t n = std::distance( first, last );
+	if( n < 3 ) { return std::copy( first, last, out ); }
+
+	const accum_t limit = accum_t( tolerance ) * tolerance;
+	std::vector<range_t> stack;
+	stack.emplace_back( 0, n - 1 );
+	while( !stack.empty( ) ) {
+		const range_t range = stack.back( );
+		stack.pop_back( );
+
+		accum_t furthest = 0;
+		std::size_t split = range.first;
+		for( std::size_t i = range.first + 1; i < range.second; ++i ) {
+			const accum_t d = detail::simplify::distance_sq( first[i], first[range.first], first[range.second] );
+			if( d > furthest ) {
+				furthest = d;
+				split = i;
+			}
+		}
+
+		if( furthest > limit ) {
+			stack.emplace_back( split, range.second );
+			stack.emplace_back( range.first, split );
+		}
+		else {
+			// the end is written as the start of the next range
+			*out++ = first[range.first];
+		}
+	}
+	*out++ = first[n-1];
+	return out;
+}
+
+template<typename T, std::size_t D>
+std::vector<point<T,D>> douglas_peucker( const std::vector<point<T,D>>& points, T tolerance ) {
+	std::vector<point<T,D>> result;
+	douglas_peucker( points.begin( ), points.end( ), tolerance, std::back_inserter( result ) );
+	return result;
+}
+
+
+////////////////////////////////////////
+// Visvalingam-Whyatt
+//   writes the kept points of [ first, last ) to out, in order;
+//   every point dropped spanned a triangle under area
+
+template<typename T, std::size_t D, typename OutputIt>
+OutputIt visvalingam_whyatt( const point<T,D>* first, const point<T,D>* last, T area, OutputIt out ) {
+	typedef typename detail::simplify::accumulator<T>::type accum_t;
+
+	const std::size_t n = last - first;
+	if( n < 3 ) { return std::copy( first, last, out ); }
+
+	detail::simplify::workspace<T> ws;
+	ws.run( first, n, accum_t(4) * area * area );
+	for( std::size_t i = 0; i != std::size_t(-1); i = ws.next[i] ) { *out++ = first[i]; }
+	return out;
+}
+
+template<typename T, std::size_t D>
+std::vector<point<T,D>> visvalingam_whyatt( const std::vector<point<T,D>>& points, T area ) {
+	std::vector<point<T,D>> result;
+	visvalingam_whyatt( points.data( ), points.data( ) + points.size( ), area, std::back_inserter( result ) );
+	return result;
+}
+
+
+////////////////////////////////////////
+// Visvalingam-Whyatt over a window
+//   holds at most window points, push( ) the track in order and
+//   finish( ) at the end; both write what is settled to out
+
+template<typename T, std::size_t D>
+class visvalingam_stream {
+// Typedefs
+public:
+
+	typedef point<T,D>           point_t;
+	typedef std::size_t          size_t;
+
+private:
+
+	typedef typename detail::simplify::accumulator<T>::type accum_t;
+
+
+// Variables
+private:
+
+	std::vector<point_t>             m_window;
+	std::vector<point_t>             m_kept;      // scratch for flush( )
+	detail::simplify::workspace<T>   m_ws;
+	accum_t                          m_limit;
+	size_t                           m_capacity;
+	bool                             m_written;   // m_window[0] is already out
+
+
+// Constructors
+public:
+
+	visvalingam_stream( T area, size_t window = 4096 ) :
+		m_limit( accum_t(4) * area * area ),
+		m_capacity( std::max( window, size_t(8) ) ),
+		m_written( false ) {
+		m_window.reserve( m_capacity );
+		m_kept.reserve( m_capacity );
+	}
+
+
+// Methods
+public:
+
+	template<typename OutputIt>
+	OutputIt push( const point_t& pt, OutputIt out ) {
+		m_window.push_back( pt );
+		if( m_window.size( ) == m_capacity ) { out = flush( out, false ); }
+		return out;
+	}
+
+	template<typename OutputIt>
+	OutputIt finish( OutputIt out ) {
+		out = flush( out, true );
+		m_window.clear( );
+		m_written = false;
+		return out;
+	}
+
+private:
+
+	// Simplifies the window and writes out the front of what is left
+	//   keeping the last point written as the start of the next window
+	template<typename OutputIt>
+	OutputIt flush( OutputIt out, bool all ) {
+		const size_t n = m_window.size( );
+		if( n == 0 ) { return out; }
+
+		m_ws.run( m_window.data( ), n, m_limit );
+		m_kept.clear( );
+		for( size_t i = 0; i != size_t(-1); i = m_ws.next[i] ) { m_kept.push_back( m_window[i] ); }
+
+		// all but half a window is settled, so each flush makes room
+		const size_t half = m_capacity / 2;
+		const size_t settled = all ? m_kept.size( ) : ( m_kept.size( ) > half ? m_kept.size( ) - half : 1 );
+		for( size_t i = m_written ? 1 : 0; i < settled; ++i ) { *out++ = m_kept[i]; }
+
+		if( !all ) {
+			m_window.assign( m_kept.begin( ) + ( settled - 1 ), m_kept.end( ) );
+			m_written = true;
+		}
+		return out;
+	}
+
+}; // End class visvalingam_stream<T,D>
+
+}  // End namespace euclib
+
+#endif // EUBLIB_SIMPLIFY_HPP
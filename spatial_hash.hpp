@@ -0,0 +1,260 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_SPATIAL_HASH_HPP
+#define EUBLIB_SPATIAL_HASH_HPP
+
+#include <cstddef>	// for std::size_t
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <vector>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <cassert>
+
+#include "point.hpp"
+
+/*
+ * Uniform grid over a point set
+ *
+ *   Space is cut into cubes of a given size and every cell is hashed into
+ *   a table of buckets, so the grid has no bounds and empty space costs
+ *   nothing.  The table is built in one go with a counting sort: count the
+ *   points in each bucket, take the running sum as where each bucket
+ *   starts, then drop every point into place.  All the buckets are then
+ *   ranges of one flat array, with each point's coordinates stored next
+ *   to its index so a query reads a bucket front to back.
+ *
+ *   Queries hand back indices into the range the grid was built from, so
+ *   the points can carry whatever else the caller keeps alongside them.
+ *   A cell a little larger than the usual query radius is a good choice;
+ *   a radius query then looks at 2^D to 3^D cells.
+ */
+
+namespace euclib {
+
+template<typename T, std::size_t D>
+class spatial_hash_grid {
+// Typedefs
+protected:
+
+	static_assert( std::is_floating_point<T>::value,
+	               "T must be floating point" );
+	static_assert( D != 0, "cannot have 0-dimensional object" );
+
+public:
+
+	typedef T                          value_t;
+	typedef std::size_t                size_t;
+	typedef std::array<std::int64_t,D> cell_t;
+
+
+// Variables
+private:
+
+	T                        m_cell_size;
+	T                        m_inv_cell_size;
+	std::size_t              m_mask;      // bucket count - 1, a power of two
+	std::vector<std::size_t> m_start;     // bucket b is [ m_start[b], m_start[b+1] )
+	std::vector<point<T,D>>  m_points;    // the points bucket by bucket
+	std::vector<std::size_t> m_index;     //   and where each came from
+
+
+// Constructors
+public:
+
+	explicit spatial_hash_grid( T cell_size ) :
+		m_cell_size( cell_size ),
+		m_inv_cell_size( T(1) / cell_size ),
+		m_mask( 0 ),
+		m_start( 2, 0 ) {
+		assert( cell_size > T(0) );
+	}
+
+	template<typename ForwardIt>
+	spatial_hash_grid( T cell_size, ForwardIt first, ForwardIt last ) :
+		spatial_hash_grid( cell_size ) {
+		build( first, last );
+	}
+
+	spatial_hash_grid( T cell_size, const std::vector<point<T,D>>& points ) :
+		spatial_hash_grid( cell_size ) {
+		build( points.begin( ), points.end( ) );
+	}
+
+
+// Methods
+public:
+
+	size_t size( ) const         { return m_points.size( ); }
+	bool empty( ) const          { return m_points.empty( ); }
+	T cell_size( ) const         { return m_cell_size; }
+	size_t bucket_count( ) const { return m_mask + 1; }
+
+	// Replaces the contents with [ first, last ), two passes over the range
+	//   the table has as many buckets as points, rounded up to a power of
+	//   two, and keeps its memory for the next build of a similar size
+	template<typename ForwardIt>
+	void build( ForwardIt first, ForwardIt last ) {
+		const size_t n = static_cast<size_t>( std::distance( first, last ) );
+		size_t buckets = 1;
+		while( buckets < n ) { buckets <<= 1; }
+		m_mask = buckets - 1;
+
+		// how many in each bucket, then where each bucket starts
+		m_start.assign( buckets + 1, 0 );
+		for( ForwardIt itr = first; itr != last; ++itr ) {
+			++m_start[bucket( cell_of( *itr ) ) + 1];
+		}
+		for( size_t b = 0; b < buckets; ++b ) { m_start[b+1] += m_start[b]; }
+
+		// each point into the next free place of its bucket, m_start[b]
+		//   runs up to where bucket b + 1 starts and is shifted back after
+		m_points.resize( n );
+		m_index.resize( n );
+		size_t i = 0;
+		for( ForwardIt itr = first; itr != last; ++itr, ++i ) {
+			const size_t at = m_start[bucket( cell_of( *itr ) )]++;
+			m_points[at] = *itr;
+			m_index[at]  = i;
+		}
+		for( size_t b = buckets; b > 0; --b ) { m_start[b] = m_start[b-1]; }
+		m_start[0] = 0;
+	}
+
+	void clear( ) {
+		m_mask = 0;
+		m_start.assign( 2, 0 );
+		m_points.clear( );
+		m_index.clear( );
+	}
+
+	// The cell a point falls in, cell c covers [ c size, ( c + 1 ) size )
+	cell_t cell_of( const point<T,D>& pt ) const {
+		using std::floor;
+		cell_t cell;
+		for( std::size_t d = 0; d < D; ++d ) {
+			cell[d] = static_cast<std::int64_t>( floor( pt[d] * m_inv_cell_size ) );
+		}
+		return cell;
+	}
+
+	// f( index ) for every point in the cell
+	template<typename F>
+	void for_each_in_cell( const cell_t& cell, F f ) const {
+		const size_t b = bucket( cell );
+		for( size_t k = m_start[b]; k < m_start[b+1]; ++k ) {
+			if( cell_of( m_points[k] ) == cell ) { f( m_index[k] ); }
+		}
+	}
+
+	// f( index ) for every point within radius of center, boundary included
+	//   each point is reached from its own cell only, so two cells of the
+	//   query that share a bucket do not report it twice; when the query
+	//   covers more cells than there are points it is cheaper to look at
+	//   every point once
+	template<typename F>
+	void for_each_in_radius( const point<T,D>& center, T radius, F f ) const {
+		if( m_points.empty( ) || radius < T(0) ) { return; }
+		const T radius_sq = radius * radius;
+
+		point<T,D> lo, hi;
+		for( std::size_t d = 0; d < D; ++d ) {
+			lo[d] = center[d] - radius;
+			hi[d] = center[d] + radius;
+		}
+		const cell_t first = cell_of( lo ), last = cell_of( hi );
+		T cells = T(1);
+		for( std::size_t d = 0; d < D; ++d ) { cells *= T( last[d] - first[d] + 1 ); }
+		if( cells > T( m_points.size( ) ) ) {
+			for( size_t k = 0; k < m_points.size( ); ++k ) {
+				if( distance_sq( m_points[k], center ) <= radius_sq ) { f( m_index[k] ); }
+			}
+			return;
+		}
+
+		// every cell of [ first, last ], the first coordinate fastest
+		cell_t cell = first;
+		for( ;; ) {
+			const size_t b = bucket( cell );
+			for( size_t k = m_start[b]; k < m_start[b+1]; ++k ) {
+				if( distance_sq( m_points[k], center ) <= radius_sq && cell_of( m_points[k] ) == cell ) {
+					f( m_index[k] );
+				}
+			}
+
+			std::size_t d = 0;
+			for( ; d < D && cell[d] == last[d]; ++d ) { cell[d] = first[d]; }
+			if( d == D ) { break; }
+			++cell[d];
+		}
+	}
+
+	// The indices of the points within radius of center, in no order
+	//   result is replaced
+	void query( const point<T,D>& center, T radius, std::vector<size_t>& result ) const {
+		result.clear( );
+		for_each_in_radius( center, radius, [&result]( size_t i ) { result.push_back( i ); } );
+	}
+
+	std::vector<size_t> query( const point<T,D>& center, T radius ) const {
+		std::vector<size_t> result;
+		query( center, radius, result );
+		return result;
+	}
+
+private:
+
+	// the cell coordinates are spread by large odd constants and mixed
+	//   down, nearby cells land in unrelated buckets
+	size_t bucket( const cell_t& cell ) const {
+		static const std::uint64_t primes[4] = {
+			0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull, 0xD6E8FEB86659FD93ull };
+		std::uint64_t h = 0;
+		for( std::size_t d = 0; d < D; ++d ) {
+			h += static_cast<std::uint64_t>( cell[d] ) * primes[d % 4];
+			h = ( h ^ ( h >> 29 ) ) * 0xBF58476D1CE4E5B9ull;
+		}
+		h ^= h >> 32;
+		return static_cast<size_t>( h ) & m_mask;
+	}
+
+	static T distance_sq( const point<T,D>& a, const point<T,D>& b ) {
+		T result = T(0);
+		for( std::size_t d = 0; d < D; ++d ) {
+			const T diff = a[d] - b[d];
+			result += diff * diff;
+		}
+		return result;
+	}
+
+}; // End class spatial_hash_grid<T,D>
+
+
+// Various typedefs to make usage easier
+typedef spatial_hash_grid<float,2>    spatial_hash_grid2f;
+typedef spatial_hash_grid<float,3>    spatial_hash_grid3f;
+
+typedef spatial_hash_grid<double,2>   spatial_hash_grid2d;
+typedef spatial_hash_grid<double,3>   spatial_hash_grid3d;
+
+}  // End namespace euclib
+
+#endif // EUBLIB_SPATIAL_HASH_HPP
@@ -19,151 +19,131 @@
 #ifndef EUBLIB_VECTOR_HPP
 #define EUBLIB_VECTOR_HPP
 
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+#include "type_traits.hpp"
 #include "euclib_math.hpp"
+#include "simd.hpp"
 #include "point.hpp"
 
 namespace euclib {
 
 template<typename T, std::size_t D>
-class vector : public point_base<T,D> {
+class vector;
+
+
+// Operations shared by every vector<T,D>,
+//   the specializations only add named accessors and cross products
+template<typename T, std::size_t D>
+class vector_base : public point_base<T,D> {
 // Typedefs
 protected:
 
 	typedef point_base<T,D> base_t;
 
 
-public:
-
-	typedef T               value_t;
-	typedef T&              ref_t;
-	typedef const T&        const_ref_t;
-	typedef std::size_t     size_t;
-	typedef std::array<T,D> data_t;
-	typedef const T*        raw_data_t;
-
 // Constructors
-public:
+protected: // cannot construct directly
 
-	vector( ) : base_t( ) { }
-	vector( const base_t& pt ) : base_t( pt ) { }
-	vector( base_t&& pt ) : base_t( std::forward<base_t>( pt ) ) { }
+	constexpr vector_base( ) : base_t( ) { }
+	constexpr vector_base( const base_t& pt ) : base_t( pt ) { }
 	template<typename E>
-	vector( const expression_holder<E>& expr ) : base_t( expr ) { }
+	constexpr vector_base( const expression_holder<E>& expr ) : base_t( expr ) { }
 	template<typename ... Args>
-	vector( T value, Args... values ) : base_t( value, values... ) { }
+	constexpr vector_base( T value, Args... values ) : base_t( value, values... ) { }
 
 
 // Methods
 public:
 
-	vector<T,D> normalize( ) const {
-		vector<T,D> result;
-		T len = length( );
-
-		std::transform( base_t::m_data.begin( ), base_t::m_data.end( ), result.begin( ),
-				[&len]( const T& t ) {
-					return t / len;
-				}
-		);
-
+	constexpr vector<T,D> normalize( ) const {
+		vector<T,D> result( *this );
+		result.normalize_in_place( );
 		return result;
 	}
 
-	void normalize_in_place( ) {
-		T len = length( );
-
-		std::transform( base_t::m_data.begin( ), base_t::m_data.end( ), base_t::m_data.begin( ),
-				[&len]( const T& t ) {
-					return t / len;
-				}
-		);
+	// a zero length vector is left as it is
+	constexpr void normalize_in_place( ) {
+		const T len = length( );
+		if( len > T(0) ) { *this /= len; }
 	}
 
-	T dot( const vector<T,D>& v ) const {
-		T sum = 0;
-		for( std::size_t i = 0; i < D; ++i ) {
-			sum += base_t::m_data[i] * v.m_data[i];
-		}
-		return sum;
+	constexpr T dot( const vector_base<T,D>& v ) const {
+		return base_t::kernel_t::dot( base_t::m_data.data( ), v.m_data.data( ) );
 	}
 
-	inline T length( ) const { return sqrt( length_sq( ) ); }
+	inline T length( ) const { using std::sqrt; return sqrt( length_sq( ) ); }
 
-	inline T length_sq( ) const {
-		T len = 0;
-		for( std::size_t i = 0; i < D; ++i ) {
-			len += base_t::m_data[i] * base_t::m_data[i];
-			assert( len > base_t::m_data[i] ); // quick code to catch some overflows
-		}
-		return len;
+	constexpr T length_sq( ) const {
+		return base_t::kernel_t::dot( base_t::m_data.data( ), base_t::m_data.data( ) );
 	}
 
+	constexpr const T* c_ptr( ) const { return base_t::m_data.data( ); }
+
+}; // End class vector_base<T,D>
+
+
+template<typename T, std::size_t D>
+class vector : public vector_base<T,D> {
+// Typedefs
+protected:
+
+	typedef point_base<T,D>  base_t;
+	typedef vector_base<T,D> vector_base_t;
+
+
+// Constructors
+public:
+
+	constexpr vector( ) : vector_base_t( ) { }
+	constexpr vector( const base_t& pt ) : vector_base_t( pt ) { }
+	template<typename E>
+	constexpr vector( const expression_holder<E>& expr ) : vector_base_t( expr ) { }
+	template<typename ... Args>
+	constexpr vector( T value, Args... values ) : vector_base_t( value, values... ) { }
+
 }; // End class vector<T,D>
 
 
-template<typename T, unsigned int D>
-T dot( const vector<T,D>& v1, const vector<T,D>& v2 ) { return v1.dot( v2 ); }
+template<typename T, std::size_t D>
+constexpr T dot( const vector<T,D>& v1, const vector<T,D>& v2 ) { return v1.dot( v2 ); }
 
 
 template<typename T>
-class vector<T,2> : public point_base<T,2> {
+class vector<T,2> : public vector_base<T,2> {
 // Typedefs
 protected:
 
-	typedef point_base<T,2> base_t;
+	typedef point_base<T,2>  base_t;
+	typedef vector_base<T,2> vector_base_t;
 
 
 // Constructors
 public:
 
-	vector( ) : base_t( ) { }
-	vector( const base_t& pt ) : base_t( pt ) { }
-	vector( base_t&& pt ) : base_t( std::forward<base_t>( pt ) ) { }
+	constexpr vector( ) : vector_base_t( ) { }
+	constexpr vector( const base_t& pt ) : vector_base_t( pt ) { }
 	template<typename E>
-	vector( const expression_holder<E>& expr ) : base_t( expr ) { }
-	template<typename ... Args>
-	vector( T value, Args... values ) : base_t( value, values... ) { }
+	constexpr vector( const expression_holder<E>& expr ) : vector_base_t( expr ) { }
+	constexpr vector( T x ) : vector_base_t( x ) { }
+	constexpr vector( T x, T y ) : vector_base_t( x, y ) { }
 
 
 // Methods
 public:
 
-	T&  x( ) { return base_t::m_data[0]; }
-	T&  y( ) { return base_t::m_data[1]; }
-	T   x( ) const { return base_t::m_data[0]; }
-	T   y( ) const { return base_t::m_data[1]; }
-
-	vector<T,2> normalize( ) const {
-		T len = length( );
-		return vector<T,2> {
-		    base_t::m_data[0] / len,
-		    base_t::m_data[1] / len
-		};
-	}
+	constexpr T&  x( ) { return base_t::m_data[0]; }
+	constexpr T&  y( ) { return base_t::m_data[1]; }
+	constexpr T   x( ) const { return base_t::m_data[0]; }
+	constexpr T   y( ) const { return base_t::m_data[1]; }
 
-	void normalize_in_place( ) {
-		T len = length( );
-		base_t::m_data[0] /= len;
-		base_t::m_data[1] /= len;
-	}
-
-	T dot( const vector<T,2>& v ) const {
-		return base_t::m_data[0] * v.m_data[0] + base_t::m_data[1] * v.m_data[1];
-	}
-
-	T cross( const vector<T,2>& v ) const {
+	constexpr T cross( const vector<T,2>& v ) const {
 		return base_t::m_data[0] * v.m_data[1] - base_t::m_data[1] * v.m_data[0];
 	}
 
-	inline T length( ) const { return sqrt( length_sq( ) ); }
-
-	inline T length_sq( ) const {
-		return base_t::m_data[0] * base_t::m_data[0] +
-		       base_t::m_data[1] * base_t::m_data[1];
-	}
-
-	const T* c_ptr( ) const { return base_t::m_data.data( ); }
-
 // Operators
 public:
 
@@ -182,189 +162,238 @@ public:
 
 
 template<typename T>
-vector<T,2> cross( const vector<T,2>& v1, const vector<T,2>& v2 ) { return v1.cross( v2 ); }
-
-template<typename T>
-T dot( const vector<T,2>& v1, const vector<T,2>& v2 ) { return v1.dot( v2 ); }
+constexpr T cross( const vector<T,2>& v1, const vector<T,2>& v2 ) { return v1.cross( v2 ); }
 
 
 template<typename T>
-class vector<T,3> : public point_base<T,3> {
+class vector<T,3> : public vector_base<T,3> {
 // Typedefs
 protected:
 
-	typedef point_base<T,3> base_t;
+	typedef point_base<T,3>  base_t;
+	typedef vector_base<T,3> vector_base_t;
 
 
 // Constructors
 public:
 
-	vector( ) : base_t( ) { }
-	vector( const base_t& pt ) : base_t( pt ) { }
-	vector( base_t&& pt ) : base_t( std::forward<base_t>( pt ) ) { }
+	constexpr vector( ) : vector_base_t( ) { }
+	constexpr vector( const base_t& pt ) : vector_base_t( pt ) { }
 	template<typename E>
-	vector( const expression_holder<E>& expr ) : base_t( expr ) { }
-	vector( T x ) : base_t( x ) { }
-	vector( T x, T y ) : base_t( x, y ) { }
-	vector( T x, T y, T z ) : base_t( x, y, z ) { }
+	constexpr vector( const expression_holder<E>& expr ) : vector_base_t( expr ) { }
+	constexpr vector( T x ) : vector_base_t( x ) { }
+	constexpr vector( T x, T y ) : vector_base_t( x, y ) { }
+	constexpr vector( T x, T y, T z ) : vector_base_t( x, y, z ) { }
 
 
 // Methods
 public:
 
-	T&  x( ) { return base_t::m_data[0]; }
-	T&  y( ) { return base_t::m_data[1]; }
-	T&  z( ) { return base_t::m_data[2]; }
-	T   x( ) const { return base_t::m_data[0]; }
-	T   y( ) const { return base_t::m_data[1]; }
-	T   z( ) const { return base_t::m_data[2]; }
-
-	vector<T,3> normalize( ) const {
-		T len = length( );
-		return vector<T,3> {
-		    base_t::m_data[0] / len,
-		    base_t::m_data[1] / len,
-		    base_t::m_data[2] / len
-		};
-	}
-
-	void normalize_in_place( ) {
-		T len = length( );
-		base_t::m_data[0] /= len;
-		base_t::m_data[1] /= len;
-		base_t::m_data[2] /= len;
-	}
+	constexpr T&  x( ) { return base_t::m_data[0]; }
+	constexpr T&  y( ) { return base_t::m_data[1]; }
+	constexpr T&  z( ) { return base_t::m_data[2]; }
+	constexpr T   x( ) const { return base_t::m_data[0]; }
+	constexpr T   y( ) const { return base_t::m_data[1]; }
+	constexpr T   z( ) const { return base_t::m_data[2]; }
 
-	T dot( const vector<T,3>& v ) const {
-		return base_t::m_data[0] * v.m_data[0] +
-		       base_t::m_data[1] * v.m_data[1] +
-		       base_t::m_data[2] * v.m_data[2];
-	}
-
-	vector<T,3> cross( const vector<T,3>& v ) const {
-		vector<T,3> result;
-		result.m_data[0] = base_t::m_data[1] * v.m_data[2] -
-		                   base_t::m_data[2] * v.m_data[1];
-		result.m_data[1] = base_t::m_data[0] * v.m_data[2] -
-		                   base_t::m_data[2] * v.m_data[0];
-		result.m_data[2] = base_t::m_data[0] * v.m_data[1] -
-		                   base_t::m_data[1] * v.m_data[0];
-		return result;
+	constexpr vector<T,3> cross( const vector<T,3>& v ) const {
+		return vector<T,3>( euclib::cross( *this, v ) );
 	}
 
 	// this x ( v1 x v2 )
-	vector<T,3> vector_triple( const vector<T,3>& v1, const vector<T,3>& v2 ) const {
+	constexpr vector<T,3> vector_triple( const vector<T,3>& v1, const vector<T,3>& v2 ) const {
 		return this->cross( v1.cross( v2 ) );
 	}
 
 	// this . ( v1 x v2 )
-	T vector_scalar( const vector<T,3>& v1, const vector<T,3>& v2 ) const {
+	constexpr T vector_scalar( const vector<T,3>& v1, const vector<T,3>& v2 ) const {
 		return this->dot( v1.cross( v2 ) );
 	}
 
-	inline T length( ) const { return sqrt( length_sq( ) ); }
-
-	inline T length_sq( ) const {
-		return base_t::m_data[0] * base_t::m_data[0] +
-		       base_t::m_data[1] * base_t::m_data[1] +
-		       base_t::m_data[2] * base_t::m_data[2];
-	}
-
-	const T* c_ptr( ) const { return base_t::m_data.data( ); }
-
 }; // End class vector<T,3>
 
 
 // v1 x ( v2 x v3 )
 template<typename T>
-vector<T,3> vector_triple( const vector<T,3>& v1, const vector<T,3>& v2, const vector<T,3>& v3 ) { return v1.cross( v2.cross( v3 ) ); }
+constexpr vector<T,3> vector_triple( const vector<T,3>& v1, const vector<T,3>& v2, const vector<T,3>& v3 ) { return v1.cross( v2.cross( v3 ) ); }
 
 // v1 . ( v2 x v3 )
 template<typename T>
-T scalar_triple( const vector<T,3>& v1, const vector<T,3>& v2, const vector<T,3>& v3 ) { return v1.dot( v2.cross( v3 ) ); }
+constexpr T scalar_triple( const vector<T,3>& v1, const vector<T,3>& v2, const vector<T,3>& v3 ) { return v1.dot( v2.cross( v3 ) ); }
 
-template<typename T>
-vector<T,3> cross( const vector<T,3>& v1, const vector<T,3>& v2 ) { return v1.cross( v2 ); }
 
 template<typename T>
-T dot( const vector<T,3>& v1, const vector<T,3>& v2 ) { return v1.dot( v2 ); }
-
-
-template<typename T>
-class vector<T,4> : public point_base<T,4> {
+class vector<T,4> : public vector_base<T,4> {
 // Typedefs
 protected:
 
-	typedef point_base<T,4> base_t;
+	typedef point_base<T,4>  base_t;
+	typedef vector_base<T,4> vector_base_t;
 
 
 // Constructors
 public:
 
-	vector( ) : base_t( ) { }
-	vector( const base_t& pt ) : base_t( pt ) { }
-	vector( base_t&& pt ) : base_t( std::forward<base_t>( pt ) ) { }
+	constexpr vector( ) : vector_base_t( ) { }
+	constexpr vector( const base_t& pt ) : vector_base_t( pt ) { }
 	template<typename E>
-	vector( const expression_holder<E>& expr ) : base_t( expr ) { }
-	vector( T x ) : base_t( x ) { }
-	vector( T x, T y ) : base_t( x, y ) { }
-	vector( T x, T y, T z ) : base_t( x, y, z ) { }
-	vector( T x, T y, T z, T w ) : base_t( x, y, z, w ) { }
+	constexpr vector( const expression_holder<E>& expr ) : vector_base_t( expr ) { }
+	constexpr vector( T x ) : vector_base_t( x ) { }
+	constexpr vector( T x, T y ) : vector_base_t( x, y ) { }
+	constexpr vector( T x, T y, T z ) : vector_base_t( x, y, z ) { }
+	constexpr vector( T x, T y, T z, T w ) : vector_base_t( x, y, z, w ) { }
 
 
 // Methods
 public:
 
-	T&  x( ) { return base_t::m_data[0]; }
-	T&  y( ) { return base_t::m_data[1]; }
-	T&  z( ) { return base_t::m_data[2]; }
-	T&  w( ) { return base_t::m_data[3]; }
-	T   x( ) const { return base_t::m_data[0]; }
-	T   y( ) const { return base_t::m_data[1]; }
-	T   z( ) const { return base_t::m_data[2]; }
-	T   w( ) const { return base_t::m_data[3]; }
-
-	vector<T,4> normalize( ) const {
-		T len = length( );
-		return vector<T,4> {
-		    base_t::m_data[0] / len,
-		    base_t::m_data[1] / len,
-		    base_t::m_data[2] / len,
-		    base_t::m_data[3] / len
-		};
+	constexpr T&  x( ) { return base_t::m_data[0]; }
+	constexpr T&  y( ) { return base_t::m_data[1]; }
+	constexpr T&  z( ) { return base_t::m_data[2]; }
+	constexpr T&  w( ) { return base_t::m_data[3]; }
+	constexpr T   x( ) const { return base_t::m_data[0]; }
+	constexpr T   y( ) const { return base_t::m_data[1]; }
+	constexpr T   z( ) const { return base_t::m_data[2]; }
+	constexpr T   w( ) const { return base_t::m_data[3]; }
+
+}; // End class vector<T,4>
+
+
+////////////////////////////////////////
+// Batch operations over arrays of vectors
+//   the squared lengths of a packet's worth of vectors are gathered and
+//   their square roots taken together.  Zero length vectors normalize to
+//   the zero vector; one whose squared length underflows or overflows is
+//   scaled by its largest coordinate first, so it still normalizes to
+//   unit length.  length( ) gives the same value as vector::length( ),
+//   which is inf where the squared length overflows.
+
+namespace detail {
+
+	// the squared lengths of a packet's worth of vectors, added in the
+	//   order vector::length_sq( ) adds them; when a vector fills a
+	//   packet they are turned into columns so the lanes add side by side
+	template<typename T, std::size_t D>
+	void length_sq( const vector<T,D>* data, T* out ) {
+		typedef simd::packet<T>         packet_t;
+		typedef typename packet_t::type type;
+		const std::size_t N = packet_t::size;
+
+		if constexpr( D == N && N > 1 ) {
+			type rows[N];
+			for( std::size_t k = 0; k < N; ++k ) { rows[k] = packet_t::loadu( data[k].c_ptr( ) ); }
+			packet_t::transpose( rows );
+			type sum = packet_t::mul( rows[0], rows[0] );
+			for( std::size_t d = 1; d < D; ++d ) { sum = packet_t::add( sum, packet_t::mul( rows[d], rows[d] ) ); }
+			packet_t::store( out, sum );
+		} else {
+			for( std::size_t k = 0; k < N; ++k ) { out[k] = data[k].length_sq( ); }
+		}
 	}
 
-	void normalize_in_place( ) {
-		T len = length( );
-		base_t::m_data[0] /= len;
-		base_t::m_data[1] /= len;
-		base_t::m_data[2] /= len;
-		base_t::m_data[3] /= len;
+	// data[k] *= factor[k] over a packet's worth of vectors
+	template<typename T, std::size_t D>
+	void scale( vector<T,D>* data, const T* factor ) {
+		typedef simd::packet<T> packet_t;
+		const std::size_t N = packet_t::size;
+
+		if constexpr( D == N && N > 1 ) {
+			for( std::size_t k = 0; k < N; ++k ) {
+				packet_t::storeu( &data[k][0], packet_t::mul( packet_t::loadu( data[k].c_ptr( ) ),
+				                                              packet_t::set1( factor[k] ) ) );
+			}
+		} else {
+			for( std::size_t k = 0; k < N; ++k ) { data[k] *= factor[k]; }
+		}
 	}
 
-	T dot( const vector<T,4>& v ) const {
-		return base_t::m_data[0] * v.m_data[0] +
-		       base_t::m_data[1] * v.m_data[1] +
-		       base_t::m_data[2] * v.m_data[2] +
-		       base_t::m_data[3] * v.m_data[3];
+	template<typename T, std::size_t D>
+	void normalize_scaled( vector<T,D>& v ) {
+		using std::abs;
+		using std::sqrt;
+		T scale = T(0);
+		for( std::size_t d = 0; d < D; ++d ) { scale = std::max( scale, T( abs( v[d] ) ) ); }
+		if( !( scale > T(0) && scale <= std::numeric_limits<T>::max( ) ) ) {
+			v = vector<T,D>( );  // zero, or no finite length to scale by
+			return;
+		}
+		v /= scale;
+		v *= T(1) / sqrt( v.length_sq( ) );
 	}
 
-	inline T length( ) const { return sqrt( length_sq( ) ); }
+	template<typename T, std::size_t D>
+	void normalize( vector<T,D>* data, std::size_t count ) {
+		typedef simd::packet<T> packet_t;
+		const std::size_t N = packet_t::size;
+		const T low = std::numeric_limits<T>::min( ), high = std::numeric_limits<T>::max( );
+
+		alignas( typename packet_t::type ) T lsq[N];
+		alignas( typename packet_t::type ) T inv[N];
+		std::size_t i = 0;
+		for( ; i + N <= count; i += N ) {
+			length_sq( data + i, lsq );
+			packet_t::store( inv, packet_t::rsqrt( packet_t::load( lsq ) ) );
+			bool normal = true;
+			for( std::size_t k = 0; k < N; ++k ) { normal &= ( lsq[k] >= low ) & ( lsq[k] <= high ); }
+			if( normal ) {
+				scale( data + i, inv );
+				continue;
+			}
+			for( std::size_t k = 0; k < N; ++k ) {
+				if( lsq[k] >= low && lsq[k] <= high ) { data[i+k] *= inv[k]; }
+				else                                  { normalize_scaled( data[i+k] ); }
+			}
+		}
+		for( ; i < count; ++i ) {
+			using std::sqrt;
+			const T sq = data[i].length_sq( );
+			if( sq >= low && sq <= high ) { data[i] *= T(1) / sqrt( sq ); }
+			else                          { normalize_scaled( data[i] ); }
+		}
+	}
 
-	inline T length_sq( ) const {
-		return base_t::m_data[0] * base_t::m_data[0] +
-		       base_t::m_data[1] * base_t::m_data[1] +
-		       base_t::m_data[2] * base_t::m_data[2] +
-		       base_t::m_data[3] * base_t::m_data[3];
+	template<typename T, std::size_t D>
+	void length( const vector<T,D>* data, std::size_t count, T* out ) {
+		typedef simd::packet<T> packet_t;
+		const std::size_t N = packet_t::size;
+
+		alignas( typename packet_t::type ) T block[N];
+		std::size_t i = 0;
+		for( ; i + N <= count; i += N ) {
+			length_sq( data + i, block );
+			packet_t::store( block, packet_t::sqrt( packet_t::load( block ) ) );
+			for( std::size_t k = 0; k < N; ++k ) { out[i+k] = block[k]; }
+		}
+		for( ; i < count; ++i ) {
+			using std::sqrt;
+			out[i] = sqrt( data[i].length_sq( ) );
+		}
 	}
 
-	const T* c_ptr( ) const { return base_t::m_data.data( ); }
+} // End namespace detail
 
-}; // End class vector<T,4>
 
+template<typename T, std::size_t D>
+void normalize( vector<T,D>* data, std::size_t count ) {
+	detail::normalize( data, count );
+}
 
-template<typename T>
-T dot( const vector<T,4>& v1, const vector<T,4>& v2 ) { return v1.dot( v2 ); }
+template<typename T, std::size_t D>
+void normalize( std::vector<vector<T,D>>& vectors ) {
+	normalize( vectors.data( ), vectors.size( ) );
+}
+
+// out must have room for count values
+template<typename T, std::size_t D>
+void length( const vector<T,D>* data, std::size_t count, T* out ) {
+	detail::length( data, count, out );
+}
+
+template<typename T, std::size_t D>
+void length( const std::vector<vector<T,D>>& vectors, std::vector<T>& out ) {
+	out.resize( vectors.size( ) );
+	length( vectors.data( ), vectors.size( ), out.data( ) );
+}
 
 
 // Various typedefs to make usage easier
@@ -394,6 +423,24 @@ typedef vector<decimal128,3>  vector3d128;
 typedef vector<decimal128,4>  vector4d128;
 #endif
 
+template<typename T> using vector2 = vector<T,2>;
+template<typename T> using vector3 = vector<T,3>;
+template<typename T> using vector4 = vector<T,4>;
+
+
+static_assert( std::is_trivially_copyable<vector2f>::value &&
+               std::is_trivially_copyable<vector3d>::value &&
+               std::is_trivially_copyable<vector<double,8>>::value,
+               "vector must be trivially copyable" );
+static_assert( std::is_standard_layout<vector2f>::value &&
+               std::is_standard_layout<vector3d>::value &&
+               std::is_standard_layout<vector<double,8>>::value,
+               "vector must be standard layout" );
+static_assert( sizeof(vector2f) == 2*sizeof(float) &&
+               sizeof(vector3d) == 3*sizeof(double) &&
+               sizeof(vector<double,8>) == 8*sizeof(double),
+               "vector must be exactly the size of its coordinates" );
+
 }  // End namespace euclib
 
 #endif // EUCLIB_VECTOR_HPP
@@ -20,6 +20,9 @@
 #define EUBLIB_VECTOR_EXPRESSION_HPP
 
 #include <cstddef>	// for std::size_t
+#include <cmath>
+#include <utility>	// for std::index_sequence
+#include <cassert>
 #include <boost/mpl/if.hpp>
 #include <boost/mpl/less_equal.hpp>
 #include <boost/mpl/sizeof.hpp>
@@ -63,6 +66,36 @@ namespace mpl {
 	template<typename T>
 	struct promotion_<T,T> { typedef T type; };
 
+	// Number of coordinates an expression yields,
+	//   0 for operands that broadcast (scalars)
+	template<typename E>
+	struct dimension_of : std::integral_constant<std::size_t, 0> { };
+
+	template<typename L, typename R>
+	struct dimension_of_binary :
+		std::integral_constant<std::size_t, ( dimension_of<L>::value > dimension_of<R>::value ?
+		                                          dimension_of<L>::value : dimension_of<R>::value )> { };
+
+	// Dimension of the point clouds an expression runs over,
+	//   0 when it runs over none; its length is then only known at run time
+	template<typename E>
+	struct cloud_dimension_of : std::integral_constant<std::size_t, 0> { };
+
+	template<typename L, typename R>
+	struct cloud_dimension_of_binary :
+		std::integral_constant<std::size_t, ( cloud_dimension_of<L>::value > cloud_dimension_of<R>::value ?
+		                                          cloud_dimension_of<L>::value : cloud_dimension_of<R>::value )> { };
+
+	// Clouds only mix with clouds of the same dimension and with scalars,
+	//   a point or vector would be read past its end
+	template<typename L, typename R>
+	struct is_cloud_compatible :
+		std::integral_constant<bool, cloud_dimension_of_binary<L,R>::value == 0 ||
+		                             ( dimension_of_binary<L,R>::value == 0 &&
+		                               ( cloud_dimension_of<L>::value == 0 ||
+		                                 cloud_dimension_of<R>::value == 0 ||
+		                                 cloud_dimension_of<L>::value == cloud_dimension_of<R>::value ) )> { };
+
 } // End namespace mpl
 
 
@@ -72,16 +105,15 @@ struct expression_holder {
 	typedef T expression_t;
 
 // Operators
-	operator const T& ( ) const {
+	constexpr operator const T& ( ) const {
 		return *static_cast<const T*>( this );
 	}
-private:
-	const expression_holder& operator = ( const expression_holder& );
 
 // Constructors
 protected:
-	expression_holder( ) { }
-	virtual ~expression_holder( ) { }
+	// no virtual destructor, holders are never deleted through a base pointer
+	//   and a vtable would make every point larger than its coordinates
+	expression_holder( ) = default;
 };
 
 ////////////////////////////////////////
@@ -101,10 +133,10 @@ public:
 	typedef std::size_t  size_t;
 
 // Constructors
-	scalar( const T& v ) : m_value( v ) { }
+	constexpr scalar( const T& v ) : m_value( v ) { }
 
 // Operators
-	value_t operator [] ( size_t ) const { return m_value; }
+	constexpr value_t operator [] ( size_t ) const { return m_value; }
 };
 
 template<typename T>
@@ -130,17 +162,32 @@ public:
 	typedef typename mpl::promotion_<typename L::size_t,
 	                                 typename R::size_t>::type  size_t;
 
+	static_assert( mpl::is_cloud_compatible<L,R>::value,
+	               "cannot mix a point cloud with a point, a vector or another dimension" );
+
 // Constructors
-	vector_addition( const L& lhs, const R& rhs ) : m_lhs( lhs ), m_rhs( rhs ) { }
+	constexpr vector_addition( const L& lhs, const R& rhs ) : m_lhs( lhs ), m_rhs( rhs ) { }
+
+// Methods
+	constexpr const L& lhs( ) const { return m_lhs; }
+	constexpr const R& rhs( ) const { return m_rhs; }
 
 // Operators
-	value_t operator [] ( size_t i ) const {
+	constexpr value_t operator [] ( size_t i ) const {
 		return m_lhs[i] + m_rhs[i];
 	}
 };
 
+namespace mpl {
+	template<typename L, typename R>
+	struct dimension_of<vector_addition<L,R>> : dimension_of_binary<L,R> { };
+
+	template<typename L, typename R>
+	struct cloud_dimension_of<vector_addition<L,R>> : cloud_dimension_of_binary<L,R> { };
+}
+
 template<typename L, typename R>
-inline vector_addition<L,R> operator + ( const expression_holder<L>& lhs, const expression_holder<R>& rhs ) {
+constexpr vector_addition<L,R> operator + ( const expression_holder<L>& lhs, const expression_holder<R>& rhs ) {
 	return vector_addition<L,R>( lhs, rhs );
 }
 
@@ -161,17 +208,32 @@ public:
 	typedef typename mpl::promotion_<typename L::size_t,
 	                                 typename R::size_t>::type  size_t;
 
+	static_assert( mpl::is_cloud_compatible<L,R>::value,
+	               "cannot mix a point cloud with a point, a vector or another dimension" );
+
 // Constructors
-	vector_subtraction( const L& lhs, const R& rhs ) : m_lhs( lhs ), m_rhs( rhs ) { }
+	constexpr vector_subtraction( const L& lhs, const R& rhs ) : m_lhs( lhs ), m_rhs( rhs ) { }
+
+// Methods
+	constexpr const L& lhs( ) const { return m_lhs; }
+	constexpr const R& rhs( ) const { return m_rhs; }
 
 // Operators
-	value_t operator [] ( size_t i ) const {
+	constexpr value_t operator [] ( size_t i ) const {
 		return m_lhs[i] - m_rhs[i];
 	}
 };
 
+namespace mpl {
+	template<typename L, typename R>
+	struct dimension_of<vector_subtraction<L,R>> : dimension_of_binary<L,R> { };
+
+	template<typename L, typename R>
+	struct cloud_dimension_of<vector_subtraction<L,R>> : cloud_dimension_of_binary<L,R> { };
+}
+
 template<typename L, typename R>
-inline vector_subtraction<L,R> operator - ( const expression_holder<L>& lhs, const expression_holder<R>& rhs ) {
+constexpr vector_subtraction<L,R> operator - ( const expression_holder<L>& lhs, const expression_holder<R>& rhs ) {
 	return vector_subtraction<L,R>( lhs, rhs );
 }
 
@@ -194,15 +256,30 @@ public:
 	typedef typename mpl::promotion_<typename L::size_t,
 	                                 typename R::size_t>::type  size_t;
 
+	static_assert( mpl::is_cloud_compatible<L,R>::value,
+	               "cannot mix a point cloud with a point, a vector or another dimension" );
+
 // Constructors
-	vector_multiplication( const L& lhs, const R& rhs ) : m_lhs( lhs ), m_rhs( rhs ) { }
+	constexpr vector_multiplication( const L& lhs, const R& rhs ) : m_lhs( lhs ), m_rhs( rhs ) { }
+
+// Methods
+	constexpr const L& lhs( ) const { return m_lhs; }
+	constexpr const R& rhs( ) const { return m_rhs; }
 
 // Operators
-	value_t operator [] ( size_t i ) const { return m_lhs[i] * m_rhs[i]; }
+	constexpr value_t operator [] ( size_t i ) const { return m_lhs[i] * m_rhs[i]; }
 };
 
+namespace mpl {
+	template<typename L, typename R>
+	struct dimension_of<vector_multiplication<L,R>> : dimension_of_binary<L,R> { };
+
+	template<typename L, typename R>
+	struct cloud_dimension_of<vector_multiplication<L,R>> : cloud_dimension_of_binary<L,R> { };
+}
+
 template<typename L, typename R>
-inline vector_multiplication<L,R> operator * ( const expression_holder<L>& lhs,
+constexpr vector_multiplication<L,R> operator * ( const expression_holder<L>& lhs,
                                                const expression_holder<R>& rhs ) {
 	return vector_multiplication<L,R>( lhs, rhs );
 }
@@ -210,7 +287,7 @@ inline vector_multiplication<L,R> operator * ( const expression_holder<L>& lhs,
 // Scalar multiplication
 // TODO: convert to typename L::value_t if not floating or decimal
 template<typename L, typename R>
-inline
+constexpr
 typename std::enable_if< (std::is_floating_point<L>::value || mpl::is_decimal<L>::value),
                        vector_multiplication<scalar<L>,R>
 					   >::type
@@ -219,7 +296,7 @@ operator * ( L lhs, const expression_holder<R>& rhs ) {
 }
 
 template<typename L, typename R>
-inline
+constexpr
 typename std::enable_if< (std::is_floating_point<R>::value || mpl::is_decimal<R>::value),
                        vector_multiplication<L,scalar<R>>
                        >::type
@@ -228,6 +305,239 @@ operator * ( const expression_holder<L>& lhs, R rhs ) {
 }
 
 
+
+////////////////////////////////////////
+// Run time extent of an expression
+//   the size of the point clouds it runs over, 0 when it runs over none;
+//   every cloud in an expression must have the same size
+
+namespace detail {
+	template<typename E>
+	struct extent {
+		static constexpr std::size_t of( const E& ) { return 0; }
+	};
+
+	template<typename L, typename R>
+	struct extent_binary {
+		template<typename E>
+		static std::size_t of( const E& expr ) {
+			const std::size_t lhs = extent<L>::of( expr.lhs( ) );
+			const std::size_t rhs = extent<R>::of( expr.rhs( ) );
+			assert( lhs == 0 || rhs == 0 || lhs == rhs );
+			return lhs != 0 ? lhs : rhs;
+		}
+	};
+
+	template<typename L, typename R>
+	struct extent<vector_addition<L,R>> : extent_binary<L,R> { };
+	template<typename L, typename R>
+	struct extent<vector_subtraction<L,R>> : extent_binary<L,R> { };
+	template<typename L, typename R>
+	struct extent<vector_multiplication<L,R>> : extent_binary<L,R> { };
+} // End namespace detail
+
+////////////////////////////////////////
+// Reductions
+//   dot_expr and length_expr produce a single value.  They convert to
+//   value_t wherever a value is needed, and act as a scalar when they
+//   multiply an expression, so the reduction is only computed once.
+
+template<typename T>
+struct reduction_holder {
+// Typedefs
+	typedef T expression_t;
+
+// Operators
+	constexpr operator const T& ( ) const {
+		return *static_cast<const T*>( this );
+	}
+
+// Constructors
+protected:
+	reduction_holder( ) = default;
+};
+
+
+////////////////////////////////////////
+// Expr . Expr dot product
+
+template<typename L, typename R>
+class dot_expr : public reduction_holder<dot_expr<L,R>> {
+// Variables
+	typename container<L>::ref_t m_lhs;
+	typename container<R>::ref_t m_rhs;
+
+// Typedefs
+public:
+	typedef typename mpl::promotion_<typename L::value_t,
+	                                 typename R::value_t>::type value_t;
+	typedef typename mpl::promotion_<typename L::size_t,
+	                                 typename R::size_t>::type  size_t;
+
+	static const std::size_t dimension = mpl::dimension_of_binary<L,R>::value;
+	static_assert( dimension != 0, "cannot reduce an expression of unknown dimension" );
+
+// Constructors
+	constexpr dot_expr( const L& lhs, const R& rhs ) : m_lhs( lhs ), m_rhs( rhs ) { }
+
+// Methods
+	constexpr value_t value( ) const {
+		return value( std::make_index_sequence<dimension>( ) );
+	}
+
+private:
+
+	template<std::size_t... I>
+	constexpr value_t value( std::index_sequence<I...> ) const {
+		return ( ... + ( m_lhs[I] * m_rhs[I] ) );
+	}
+
+// Operators
+public:
+	constexpr operator value_t ( ) const { return value( ); }
+};
+
+template<typename L, typename R>
+constexpr dot_expr<L,R> dot( const expression_holder<L>& lhs, const expression_holder<R>& rhs ) {
+	return dot_expr<L,R>( lhs, rhs );
+}
+
+
+////////////////////////////////////////
+// |Expr| length
+
+template<typename E>
+class length_expr : public reduction_holder<length_expr<E>> {
+// Variables
+	dot_expr<E,E> m_length_sq;
+
+// Typedefs
+public:
+	typedef typename dot_expr<E,E>::value_t value_t;
+	typedef typename dot_expr<E,E>::size_t  size_t;
+
+// Constructors
+	constexpr length_expr( const E& expr ) : m_length_sq( expr, expr ) { }
+
+// Methods
+	value_t value( ) const              { using std::sqrt; return sqrt( m_length_sq.value( ) ); }
+	constexpr value_t value_sq( ) const { return m_length_sq.value( ); }
+
+// Operators
+	operator value_t ( ) const { return value( ); }
+};
+
+template<typename E>
+constexpr length_expr<E> length( const expression_holder<E>& expr ) {
+	return length_expr<E>( expr );
+}
+
+
+// Reduction * Expr, Expr * Reduction
+//   the reduction becomes a scalar operand
+template<typename L, typename R>
+constexpr vector_multiplication<scalar<typename L::value_t>,R>
+operator * ( const reduction_holder<L>& lhs, const expression_holder<R>& rhs ) {
+	typedef scalar<typename L::value_t> scalar_t;
+	return vector_multiplication<scalar_t,R>( scalar_t( static_cast<const L&>( lhs ).value( ) ), rhs );
+}
+
+template<typename L, typename R>
+constexpr vector_multiplication<L,scalar<typename R::value_t>>
+operator * ( const expression_holder<L>& lhs, const reduction_holder<R>& rhs ) {
+	typedef scalar<typename R::value_t> scalar_t;
+	return vector_multiplication<L,scalar_t>( lhs, scalar_t( static_cast<const R&>( rhs ).value( ) ) );
+}
+
+
+////////////////////////////////////////
+// Expr / |Expr| normalization
+//   the length is reduced once on construction,
+//   the coordinates are produced on demand;
+//   a zero length expression normalizes to zero
+
+template<typename E>
+class normalize_expr : public expression_holder<normalize_expr<E>> {
+// Variables
+	typename container<E>::ref_t m_expr;
+
+// Typedefs
+public:
+	typedef typename E::value_t  value_t;
+	typedef typename E::size_t   size_t;
+
+private:
+	value_t m_inv_length;
+
+// Constructors
+public:
+	normalize_expr( const E& expr ) :
+		m_expr( expr ),
+		m_inv_length( inverse( length_expr<E>( expr ).value( ) ) ) { }
+
+private:
+	static value_t inverse( value_t length ) {
+		return length > value_t(0) ? value_t(1) / length : value_t(0);
+	}
+
+public:
+
+// Operators
+	constexpr value_t operator [] ( size_t i ) const { return m_expr[i] * m_inv_length; }
+};
+
+namespace mpl {
+	template<typename E>
+	struct dimension_of<normalize_expr<E>> : dimension_of<E> { };
+}
+
+template<typename E>
+inline normalize_expr<E> normalize( const expression_holder<E>& expr ) {
+	return normalize_expr<E>( expr );
+}
+
+
+////////////////////////////////////////
+// Expr x Expr cross product (3D)
+
+template<typename L, typename R>
+class cross_expr : public expression_holder<cross_expr<L,R>> {
+// Variables
+	typename container<L>::ref_t m_lhs;
+	typename container<R>::ref_t m_rhs;
+
+// Typedefs
+public:
+	typedef typename mpl::promotion_<typename L::value_t,
+	                                 typename R::value_t>::type value_t;
+	typedef typename mpl::promotion_<typename L::size_t,
+	                                 typename R::size_t>::type  size_t;
+
+	static_assert( mpl::dimension_of<L>::value == 3 && mpl::dimension_of<R>::value == 3,
+	               "cross product is only defined for 3 dimensions" );
+
+// Constructors
+	constexpr cross_expr( const L& lhs, const R& rhs ) : m_lhs( lhs ), m_rhs( rhs ) { }
+
+// Operators
+	constexpr value_t operator [] ( size_t i ) const {
+		const size_t j = ( i == 2 ? 0 : i + 1 );
+		const size_t k = ( j == 2 ? 0 : j + 1 );
+		return m_lhs[j] * m_rhs[k] - m_lhs[k] * m_rhs[j];
+	}
+};
+
+namespace mpl {
+	template<typename L, typename R>
+	struct dimension_of<cross_expr<L,R>> : std::integral_constant<std::size_t, 3> { };
+}
+
+template<typename L, typename R>
+constexpr cross_expr<L,R> cross( const expression_holder<L>& lhs, const expression_holder<R>& rhs ) {
+	return cross_expr<L,R>( lhs, rhs );
+}
+
+
 } // End namespace euclib
 
 #endif // EUBLIB_VECTOR_EXPRESSION_HPP